@@ -1,4 +1,12 @@
 #!/bin/bash
+#
+# Usage: collect-profile.sh [--live]
+#
+# Generates the profile for the Profile build. By default the daemon runs the
+# training workload, which only the Profile build has, against a mock hwmon
+# tree; that needs neither root nor particular hardware and takes seconds. With --live it runs against
+# the real sensors with fancontrol2.prof.yaml while `stress` heats the CPU.
+#
 set -eu
 exec <&-
 
@@ -33,6 +41,26 @@ generate_profile()
 }
 
 
+# The libsensors stand-in is not instrumented; it only replaces libsensors
+# below the daemon. CMake builds it as the fancontrol2-sensors-mock target.
+sensors_mock=sensors-mock/src/mock/libfancontrol2-sensors-mock.so
+
+build_sensors_mock()
+{
+	mkdir -p sensors-mock
+	(cd sensors-mock && cmake ../.. && make fancontrol2-sensors-mock)
+}
+
+
+train_profile()
+{
+	[ -e "$sensors_mock" ] || build_sensors_mock
+	echo 'Profiling training workload ...'
+	LD_PRELOAD="$PWD/$sensors_mock" ./fancontrol2.prof --train
+	echo 'Profiling successful!'
+}
+
+
 cleanup()
 {
 	find -name '*.gcda' -delete
@@ -40,7 +68,11 @@ cleanup()
 
 
 cleanup
-generate_profile || declare -i rv="$?"
+if [ "${1-}" = --live ]; then
+	generate_profile || declare -i rv="$?"
+else
+	train_profile || declare -i rv="$?"
+fi
 if [ -v rv ]; then
 	cleanup
 	exit "$rv"
@@ -0,0 +1,119 @@
+/*
+ * adaptive_interval.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "adaptive_interval.hpp"
+#include "control_plan.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <boost/assert.hpp>
+
+
+namespace fancontrol {
+
+typedef adaptive_interval::value_t value_t;
+
+
+adaptive_interval::parameters::parameters()
+	: min(1), max(30)
+	, threshold(0.02f), margin(0.1f)
+	, factor(1.5)
+{
+}
+
+
+adaptive_interval::adaptive_interval()
+	: m_enabled(false)
+	, m_base(0)
+	, m_current(0)
+{
+}
+
+
+void adaptive_interval::configure(double base, const parameters &params)
+{
+	BOOST_ASSERT(params.min > 0 && params.min <= base && base <= params.max);
+	BOOST_ASSERT(params.threshold > 0 && params.factor > 1);
+	m_enabled = true;
+	m_params = params;
+	m_base = base;
+	reset();
+}
+
+
+void adaptive_interval::reset()
+{
+	m_current = m_base;
+	m_last_rates.clear();
+}
+
+
+/*
+ * Bounded sources measure their distance to the bounds on the unclipped
+ * scale, so a reading far below the lower bound counts as far away even
+ * though its rate is simply 0. Aggregates only contribute the change of
+ * their rate.
+ */
+double adaptive_interval::update(const control_plan &plan, const double *samples, double elapsed)
+{
+	if (!m_enabled)
+		return m_current;
+
+	const std::size_t size = plan.size();
+	const value_t *const rates = plan.rates();
+	if (m_last_rates.size() != size) {
+		// first tick or a different plan
+		m_last_rates.assign(rates, rates + size);
+		return m_current;
+	}
+
+	state s = calm;
+	const value_t max_change = static_cast<value_t>(m_params.threshold * elapsed);
+	for (std::size_t i = 0; i < size; i++) {
+		if (std::abs(rates[i] - m_last_rates[i]) > max_change)
+			s = changing;
+		m_last_rates[i] = rates[i];
+	}
+
+	if (s == calm) {
+		const std::size_t sources = plan.sources();
+		for (std::size_t i = 0; i < sources; i++) {
+			const value_t position = plan.position(i, samples);
+			const value_t distance = (position < 0) ? -position :
+				(position > 1) ? position - 1 :
+				std::min(position, 1 - position);
+			if (distance < m_params.margin) {
+				s = unsettled;
+				break;
+			}
+		}
+	}
+
+	return next(s);
+}
+
+
+double adaptive_interval::next(state s)
+{
+	switch (s) {
+		case changing:
+			m_current = m_params.min;
+			break;
+
+		case calm:
+			m_current = std::min(m_current * m_params.factor, m_params.max);
+			break;
+
+		case unsettled:
+			m_current = (m_current > m_base) ?
+				std::max(m_current / m_params.factor, m_base) :
+				std::min(m_current * m_params.factor, m_base);
+			break;
+	}
+	return m_current;
+}
+
+} /* namespace fancontrol */
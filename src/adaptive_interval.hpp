@@ -0,0 +1,110 @@
+/*
+ * adaptive_interval.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef FANCONTROL_ADAPTIVE_INTERVAL_HPP_
+#define FANCONTROL_ADAPTIVE_INTERVAL_HPP_
+
+#include <vector>
+#include <cstddef>
+
+
+namespace fancontrol {
+
+class control_plan;
+
+
+/*
+ * Chooses the period until the next tick from the control rates the plan
+ * computed in the last one.
+ *
+ * If any rate changes faster than the threshold (per second), the interval
+ * drops to its minimum. If all rates are stable and every bounded control is
+ * at least the margin away from its bounds, the interval grows by the given
+ * factor up to its maximum. Otherwise it returns stepwise to the configured
+ * base interval.
+ */
+class adaptive_interval
+{
+public:
+	typedef float value_t;
+
+	struct parameters
+	{
+		parameters();
+
+		double min, max;
+
+		value_t threshold, margin;
+
+		double factor;
+	};
+
+	adaptive_interval();
+
+	void configure(double base, const parameters &params);
+
+	bool enabled() const;
+
+	const parameters &params() const;
+
+	double base() const;
+
+	double current() const;
+
+	double update(const control_plan &plan, const double *samples, double elapsed);
+
+	void reset();
+
+private:
+	enum state {
+		calm, unsettled, changing
+	};
+
+	double next(state s);
+
+	bool m_enabled;
+
+	parameters m_params;
+
+	double m_base, m_current;
+
+	std::vector<value_t> m_last_rates;
+};
+
+
+
+// implementations ========================================
+
+inline
+bool adaptive_interval::enabled() const
+{
+	return m_enabled;
+}
+
+
+inline
+const adaptive_interval::parameters &adaptive_interval::params() const
+{
+	return m_params;
+}
+
+
+inline
+double adaptive_interval::base() const
+{
+	return m_base;
+}
+
+
+inline
+double adaptive_interval::current() const
+{
+	return m_current;
+}
+
+} /* namespace fancontrol */
+#endif /* FANCONTROL_ADAPTIVE_INTERVAL_HPP_ */
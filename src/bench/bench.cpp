@@ -0,0 +1,129 @@
+/*
+ * bench.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "bench.hpp"
+#include <algorithm>
+#include <ostream>
+#include <iomanip>
+#include <cstdio>
+
+
+namespace fancontrol {
+	namespace bench {
+
+namespace {
+
+	void write_json_string(std::ostream &out, const std::string &s)
+	{
+		out << '"';
+		for (std::string::const_iterator it = s.begin(); it != s.end(); ++it) {
+			const unsigned char c = static_cast<unsigned char>(*it);
+			if (c == '"' || c == '\\') {
+				out << '\\' << *it;
+			} else if (c < 0x20) {
+				char buf[8];
+				std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+				out << buf;
+			} else {
+				out << *it;
+			}
+		}
+		out << '"';
+	}
+
+}
+
+
+suite::suite(double min_time, unsigned repetitions)
+	: m_min_time(min_time)
+	, m_repetitions(std::max(repetitions, 1u))
+{
+}
+
+
+void suite::filter(const std::string &filter)
+{
+	m_filter = filter;
+}
+
+
+bool suite::enabled(const std::string &name) const
+{
+	return m_filter.empty() || name.find(m_filter) != std::string::npos;
+}
+
+
+void suite::context(const std::string &key, const std::string &value)
+{
+	m_context.push_back(std::make_pair(key, value));
+}
+
+
+const std::vector<result> &suite::results() const
+{
+	return m_results;
+}
+
+
+void suite::record(const std::string &name, std::size_t iterations, std::size_t items,
+	std::vector<double> &times)
+{
+	std::sort(times.begin(), times.end());
+	const std::size_t n = times.size();
+
+	result r;
+	r.name = name;
+	r.iterations = iterations;
+	r.repetitions = static_cast<unsigned>(n);
+	r.items = items;
+	r.median_ns = (n % 2) ? times[n / 2] : (times[n / 2 - 1] + times[n / 2]) / 2;
+	r.min_ns = times.front();
+	r.max_ns = times.back();
+	m_results.push_back(r);
+}
+
+
+void suite::write_json(std::ostream &out) const
+{
+	const std::streamsize precision = out.precision(6);
+	out << "{\n  \"context\": {";
+	for (std::size_t i = 0; i < m_context.size(); i++) {
+		out << (i ? ",\n    " : "\n    ");
+		write_json_string(out, m_context[i].first);
+		out << ": ";
+		write_json_string(out, m_context[i].second);
+	}
+	out << "\n  },\n  \"benchmarks\": [";
+	for (std::size_t i = 0; i < m_results.size(); i++) {
+		const result &r = m_results[i];
+		out << (i ? ",\n    {" : "\n    {") << "\"name\": ";
+		write_json_string(out, r.name);
+		out << ", \"iterations\": " << r.iterations
+			<< ", \"repetitions\": " << r.repetitions
+			<< ", \"items\": " << r.items
+			<< ", \"median_ns\": " << r.median_ns
+			<< ", \"min_ns\": " << r.min_ns
+			<< ", \"max_ns\": " << r.max_ns
+			<< ", \"items_per_second\": " << (static_cast<double>(r.items) * 1e9 / r.median_ns)
+			<< '}';
+	}
+	out << "\n  ]\n}\n";
+	out.precision(precision);
+}
+
+
+void suite::write_summary(std::ostream &out) const
+{
+	for (std::vector<result>::const_iterator it = m_results.begin(); it != m_results.end(); ++it) {
+		out << std::left << std::setw(36) << it->name << std::right
+			<< std::setw(14) << std::fixed << std::setprecision(1) << it->median_ns << " ns"
+			<< std::setw(14) << (it->median_ns / static_cast<double>(std::max<std::size_t>(it->items, 1))) << " ns/item"
+			<< std::defaultfloat << '\n';
+	}
+}
+
+	} /* namespace bench */
+} /* namespace fancontrol */
@@ -0,0 +1,148 @@
+/*
+ * bench.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef FANCONTROL_BENCH_BENCH_HPP_
+#define FANCONTROL_BENCH_BENCH_HPP_
+
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <iosfwd>
+#include <cstddef>
+#include <ctime>
+
+
+namespace fancontrol {
+	namespace bench {
+
+/*
+ * Keeps the compiler from discarding a value that a benchmark computes only
+ * to measure its computation.
+ */
+template <typename T>
+inline void do_not_optimize(const T &value)
+{
+	__asm__ __volatile__("" : : "r,m"(value) : "memory");
+}
+
+
+struct result
+{
+	std::string name;
+
+	// calls per repetition
+	std::size_t iterations;
+
+	unsigned repetitions;
+
+	// units of work per call, e.g. fans per tick
+	std::size_t items;
+
+	// nanoseconds per call over the repetitions
+	double median_ns, min_ns, max_ns;
+};
+
+
+/*
+ * Runs each benchmark often enough to take at least the minimum time per
+ * repetition and records the median, minimum and maximum time per call over
+ * all repetitions.
+ */
+class suite
+{
+public:
+	explicit suite(double min_time = 0.1, unsigned repetitions = 5);
+
+	void filter(const std::string &filter);
+
+	bool enabled(const std::string &name) const;
+
+	void context(const std::string &key, const std::string &value);
+
+	template <typename F>
+	void run(const std::string &name, F f, std::size_t items = 1);
+
+	const std::vector<result> &results() const;
+
+	void write_json(std::ostream &out) const;
+
+	void write_summary(std::ostream &out) const;
+
+private:
+	static double now();
+
+	template <typename F>
+	static double time(F &f, std::size_t iterations);
+
+	void record(const std::string &name, std::size_t iterations, std::size_t items,
+		std::vector<double> &times);
+
+	double m_min_time;
+
+	unsigned m_repetitions;
+
+	std::string m_filter;
+
+	std::vector< std::pair<std::string, std::string> > m_context;
+
+	std::vector<result> m_results;
+};
+
+
+
+// implementations ============================================================
+
+inline
+double suite::now()
+{
+	timespec t;
+	::clock_gettime(CLOCK_MONOTONIC, &t);
+	return static_cast<double>(t.tv_sec) + static_cast<double>(t.tv_nsec) * 1e-9;
+}
+
+
+template <typename F>
+double suite::time(F &f, std::size_t iterations)
+{
+	const double start = now();
+	for (std::size_t i = 0; i < iterations; i++) {
+		f();
+		__asm__ __volatile__("" : : : "memory");
+	}
+	return now() - start;
+}
+
+
+template <typename F>
+void suite::run(const std::string &name, F f, std::size_t items)
+{
+	if (!enabled(name))
+		return;
+
+	// warm up and find an iteration count that takes a tenth of the minimum time
+	const std::size_t max_iterations = std::size_t(1) << 30;
+	std::size_t iterations = 1;
+	double elapsed;
+	while ((elapsed = time(f, iterations)) < m_min_time / 10 && iterations < max_iterations)
+		iterations *= 2;
+	if (elapsed < m_min_time) {
+		iterations = static_cast<std::size_t>(std::min(static_cast<double>(max_iterations),
+			static_cast<double>(iterations) * m_min_time / std::max(elapsed, 1e-9))) + 1;
+	}
+
+	std::vector<double> times;
+	times.reserve(m_repetitions);
+	for (unsigned r = 0; r < m_repetitions; r++)
+		times.push_back(time(f, iterations) / static_cast<double>(iterations) * 1e9);
+
+	record(name, iterations, items, times);
+}
+
+	} /* namespace bench */
+} /* namespace fancontrol */
+#endif /* FANCONTROL_BENCH_BENCH_HPP_ */
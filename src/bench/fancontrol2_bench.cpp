@@ -0,0 +1,391 @@
+/*
+ * fancontrol2_bench.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+/*
+ * fancontrol2_bench: microbenchmarks of the control loop against a mock
+ * hwmon tree (see mock/hwmon.hpp). Prints the results as JSON to standard
+ * output or the file given with -o and a human-readable summary to standard
+ * error.
+ */
+
+#include "bench.hpp"
+#include "mock/hwmon.hpp"
+#include "mock/environment.hpp"
+
+#include "config.hpp"
+#include "config_cache.hpp"
+#include "control.hpp"
+#include "control_kernel.hpp"
+#include "fan.hpp"
+#include "replay.hpp"
+#include "telemetry.hpp"
+#include "sensors++/sensors.hpp"
+#include "sensors++/chip.hpp"
+#include "sensors++/feature.hpp"
+#include "sensors++/pwm.hpp"
+#include "util/stringpiece/lexical_cast.hpp"
+
+#include <boost/exception/diagnostic_information.hpp>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <string>
+#include <cstdlib>
+#include <sys/resource.h>
+#include <unistd.h>
+
+
+namespace fancontrol {
+	namespace bench {
+
+using mock::hwmon_tree;
+using sensors::sensor_container;
+using util::make_shared;
+using sensors::string_ref;
+using sensors::STRING_REF;
+
+
+namespace {
+
+struct options
+{
+	options()
+		: chips(4), scale_fans(0), read_latency_us(0), min_time(0.1), repetitions(5)
+		, output(nullptr)
+	{
+		chip.temps = 6;
+		chip.fans = 2;
+		chip.pwms = 2;
+		config.dependencies = 3;
+	}
+
+	unsigned chips;
+
+	// fans of the scaling run, which replaces the other benchmarks, or 0
+	unsigned scale_fans;
+
+	unsigned long read_latency_us;
+
+	hwmon_tree::chip_spec chip;
+
+	hwmon_tree::config_options config;
+
+	double min_time;
+
+	unsigned repetitions;
+
+	std::string filter;
+
+	const char *output;
+};
+
+
+std::string config_text(const hwmon_tree &tree, hwmon_tree::config_options options,
+	bool direct_read, const char *sampler = "sync")
+{
+	options.direct_read = direct_read;
+	options.sampler = sampler;
+	std::ostringstream s;
+	tree.write_config(s, options);
+	return s.str();
+}
+
+
+std::unique_ptr<config> make_config(const std::string &text, const shared_ptr<sensor_container> &sensors)
+{
+	std::istringstream s(text);
+	std::unique_ptr<config> cfg(new config(s, sensors));
+	cfg->auto_reset = false;
+	return cfg;
+}
+
+
+template <typename T>
+std::string to_string(const T &value)
+{
+	std::ostringstream s;
+	s << value;
+	return s.str();
+}
+
+
+void run_parsing(suite &s, const hwmon_tree &tree, const options &opt)
+{
+	const std::string text(config_text(tree, opt.config, opt.config.direct_read));
+
+	s.run("config/construct", [&text]() {
+		// a fresh container, so that chip discovery is part of the measurement
+		const std::unique_ptr<config> cfg(make_config(text, make_shared<sensor_container>()));
+		do_not_optimize(cfg->fans.size());
+	});
+
+	const shared_ptr<sensor_container> sensors(make_shared<sensor_container>());
+
+	// what a start with an unchanged compiled image pays instead of the parse
+	s.run("config/fingerprint", []() {
+		do_not_optimize(config_cache::topology_fingerprint(sensors::default_config_path));
+	});
+
+	const std::string image_path(tree.root() + "/fancontrol2.bin");
+	config_cache::write(image_path, *make_config(text, sensors), 0, 0);
+	s.run("config/load_image", [&image_path]() {
+		const config_cache::image image(image_path);
+		const std::unique_ptr<config> cfg(new config(image, make_shared<sensor_container>()));
+		cfg->auto_reset = false;
+		do_not_optimize(cfg->fans.size());
+	});
+
+	const shared_ptr<sensors::chip> chip(sensors->chip(STRING_REF("mock0")));
+	s.run("chip/feature_consume_name", [&chip]() {
+		string_ref name(STRING_REF("temp2_input"));
+		do_not_optimize(chip->feature_consume_name(name).get());
+		do_not_optimize(name);
+	});
+
+	s.run("lexical_cast/stringpiece", []() {
+		util::streamstate streamstate;
+		do_not_optimize(util::lexical_cast<int>(STRING_REF("12345_input"), &streamstate));
+	});
+}
+
+
+void run_sampling(suite &s, const hwmon_tree &tree, const options &opt,
+	const shared_ptr<sensor_container> &sensors)
+{
+	struct variant {
+		const char *name;
+		bool direct_read;
+		const char *sampler;
+	};
+	const variant variants[] = {
+		{ "snapshot/sample/libsensors", false, "sync" },
+		{ "snapshot/sample/direct", true, "sync" },
+		{ "snapshot/sample/io_uring", true, "io_uring" },
+	};
+
+	for (const variant &v : variants) {
+		// the latency interposer can't delay reads submitted through io_uring
+		if (!s.enabled(v.name) || (opt.read_latency_us != 0 && std::string(v.sampler) == "io_uring"))
+			continue;
+		const std::unique_ptr<config> cfg(make_config(config_text(tree, opt.config, v.direct_read, v.sampler), sensors));
+		if (cfg->io_uring_sampler != (std::string(v.sampler) == "io_uring") ||
+			(cfg->io_uring_sampler && !cfg->samples.use_io_uring(true)))
+		{
+			continue;
+		}
+		snapshot &samples = cfg->samples;
+		s.run(v.name, [&samples]() { samples.sample(); }, samples.size());
+	}
+}
+
+
+void run_control(suite &s, config &cfg)
+{
+	cfg.samples.sample();
+	const std::size_t fans = cfg.fans.size();
+
+	s.run("control/rate", [&cfg]() {
+		for (const config::fan_type &f : cfg.fans)
+			do_not_optimize(f->m_dependency->rate());
+	}, fans);
+
+	s.run("control_plan/evaluate", [&cfg]() {
+		cfg.plan.evaluate(cfg.samples.values());
+		do_not_optimize(cfg.plan.rates()[0]);
+	}, cfg.plan.size());
+
+	const shared_ptr<fan> &first = cfg.fans.front();
+	s.run("fan/update_valve", [&first]() { first->update_valve(true); });
+
+	const shared_ptr<pwm> &valve = first->m_valve.get();
+	pwm::value_t raw = 100;
+	s.run("pwm/raw_value/write", [&valve, &raw]() {
+		valve->raw_value(raw);
+		raw ^= 1;
+	});
+	s.run("pwm/raw_value/read", [&valve]() { do_not_optimize(valve->raw_value()); });
+
+	s.run("config/update", [&cfg]() { cfg.update(); }, fans);
+}
+
+
+// Records a trace of the mock tree and replays the configuration against it.
+void run_replay(suite &s, const hwmon_tree &tree, const options &opt,
+	const shared_ptr<sensor_container> &sensors)
+{
+	const std::string path(tree.root() + "/telemetry");
+	const std::unique_ptr<config> cfg(make_config(
+		config_text(tree, opt.config, opt.config.direct_read) +
+			"telemetry:\n    path: " + path + "\n    records: 4096\n",
+		sensors));
+	for (unsigned i = 0; i < 4096; i++)
+		cfg->update();
+	cfg->recorder.close();
+
+	const telemetry::trace trace(path);
+	const replay r(*cfg, trace);
+	s.run("replay/tick", [&r]() { do_not_optimize(r.run(nullptr).writes); }, trace.size());
+}
+
+
+long maxrss_kib()
+{
+	struct rusage usage;
+	::getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+
+/*
+ * Parses and ticks a configuration of the given number of fans, rounded up to
+ * whole chips of 10 fans and 100 temperature inputs each. Every fan depends on
+ * 10 inputs of its own, so 500 fans read 5000 temperatures. The peak resident
+ * set size is recorded before and after.
+ */
+void run_scaling(suite &s, hwmon_tree &tree, const options &opt)
+{
+	hwmon_tree::config_options settings(opt.config);
+	settings.dependencies = 10;
+	const hwmon_tree::chip_spec chip(100, 10, 10);
+	for (unsigned fans = 0; fans < opt.scale_fans; fans += chip.fans)
+		tree.add_chip(chip);
+	const std::string text(config_text(tree, settings, settings.direct_read));
+	s.context("chips", to_string(tree.chip_count()));
+	s.context("dependencies_per_fan", to_string(settings.dependencies));
+	s.context("maxrss_kib_before", to_string(maxrss_kib()));
+
+	s.run("scale/config/construct", [&text]() {
+		const std::unique_ptr<config> cfg(make_config(text, make_shared<sensor_container>()));
+		do_not_optimize(cfg->fans.size());
+	});
+
+	const std::unique_ptr<config> cfg(make_config(text, make_shared<sensor_container>()));
+	s.context("fans", to_string(cfg->fans.size()));
+	s.context("sources", to_string(cfg->samples.size()));
+	s.context("maxrss_kib_after", to_string(maxrss_kib()));
+
+	s.run("scale/config/update", [&cfg]() { cfg->update(); }, cfg->fans.size());
+}
+
+
+int usage(const char *argv0, std::ostream &out, int r)
+{
+	out << "Usage: " << argv0 << " [-c CHIPS] [-t TEMPS] [-f FANS] [-d DEPENDENCIES]"
+			" [-k 0|1] [-l LATENCY] [-s FANS] [-m MIN_TIME] [-r REPETITIONS] [-b FILTER]"
+			" [-o OUTPUT]\n"
+		"\n"
+		"Runs the benchmarks whose names contain FILTER against CHIPS (4) mock chips\n"
+		"with TEMPS (6) temperature inputs and FANS (2) fans each, every fan depending\n"
+		"on DEPENDENCIES (3) temperatures. -k sets keep_open and direct_read (1).\n"
+		"-l delays every read of a mock attribute by LATENCY (0) microseconds, e.g. to\n"
+		"compare the synchronous samplers on slow chips with -b snapshot/sample. The\n"
+		"io_uring sampler is skipped then, since its reads bypass the delay. -s runs\n"
+		"only the scaling benchmarks with FANS fans and 10 temperatures per fan instead.\n"
+		"Each benchmark runs REPETITIONS (5) times for at least MIN_TIME (0.1) seconds.\n";
+	return r;
+}
+
+}
+
+
+int main(int argc, char *argv[])
+{
+	options opt;
+	int o;
+	while ((o = ::getopt(argc, argv, "c:t:f:d:k:l:s:m:r:b:o:h")) != -1) {
+		switch (o) {
+		case 'c': opt.chips = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10)); break;
+		case 't': opt.chip.temps = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10)); break;
+		case 'f': opt.chip.fans = opt.chip.pwms = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10)); break;
+		case 'd': opt.config.dependencies = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10)); break;
+		case 'k': opt.config.keep_open = opt.config.direct_read = std::atoi(optarg) != 0; break;
+		case 'l': opt.read_latency_us = std::strtoul(optarg, nullptr, 10); break;
+		case 's': opt.scale_fans = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10)); break;
+		case 'm': opt.min_time = std::strtod(optarg, nullptr); break;
+		case 'r': opt.repetitions = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10)); break;
+		case 'b': opt.filter = optarg; break;
+		case 'o': opt.output = optarg; break;
+		case 'h': return usage(argv[0], std::cout, EXIT_SUCCESS);
+		default: return usage(argv[0], std::cerr, EXIT_FAILURE);
+		}
+	}
+	if (optind != argc || opt.chips == 0 || opt.chip.fans == 0)
+		return usage(argv[0], std::cerr, EXIT_FAILURE);
+
+	try {
+		// The stand-in reads the root and the latency from the environment
+		// once, so they must be set before any file is opened.
+		const std::string root(hwmon_tree::make_temp_root());
+		::setenv(FANCONTROL_MOCK_HWMON_ENV, root.c_str(), 1);
+		if (opt.read_latency_us != 0)
+			::setenv(FANCONTROL_MOCK_READ_LATENCY_ENV, to_string(opt.read_latency_us).c_str(), 1);
+		hwmon_tree tree(root);
+		tree.keep(false);
+
+		suite s(opt.min_time, opt.repetitions);
+		s.filter(opt.filter);
+		s.context("kernel", kernel::name());
+		s.context("compiler", __VERSION__);
+#ifdef NDEBUG
+		s.context("assertions", "off");
+#else
+		s.context("assertions", "on");
+#endif
+		s.context("keep_open", opt.config.keep_open ? "true" : "false");
+		s.context("read_latency_us", to_string(opt.read_latency_us));
+
+		if (opt.scale_fans != 0) {
+			run_scaling(s, tree, opt);
+		} else {
+			for (unsigned i = 0; i < opt.chips; i++)
+				tree.add_chip(opt.chip);
+			s.context("chips", to_string(opt.chips));
+			s.context("fans", to_string(opt.chips * opt.chip.fans));
+			s.context("dependencies_per_fan", to_string(opt.config.dependencies));
+
+			run_parsing(s, tree, opt);
+
+			const shared_ptr<sensor_container> sensors(make_shared<sensor_container>());
+			run_sampling(s, tree, opt, sensors);
+
+			const std::unique_ptr<config> cfg(make_config(
+				config_text(tree, opt.config, opt.config.direct_read), sensors));
+			s.context("sources", to_string(cfg->samples.size()));
+			run_control(s, *cfg);
+			run_replay(s, tree, opt, sensors);
+		}
+
+		if (opt.output) {
+			std::ofstream out(opt.output);
+			s.write_json(out);
+			if (!out.flush()) {
+				std::cerr << "Couldn't write " << opt.output << std::endl;
+				return EXIT_FAILURE;
+			}
+		} else {
+			s.write_json(std::cout);
+		}
+		s.write_summary(std::cerr);
+
+	} catch (boost::exception &e) {
+		std::cerr << boost::diagnostic_information(e) << std::endl;
+		return EXIT_FAILURE;
+	} catch (std::exception &e) {
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+	} /* namespace bench */
+} /* namespace fancontrol */
+
+
+int main(int argc, char *argv[])
+{
+	return fancontrol::bench::main(argc, argv);
+}
@@ -18,14 +18,14 @@
 #include "util/strcat.hpp"
 #include "util/algorithm.hpp"
 #include "util/yaml.hpp"
+#include "util/clock.hpp"
+#include "util/resource.hpp"
 //#include "util/static_allocator/static_string.hpp"
 
 #include <boost/format.hpp>
 #include <boost/range/begin.hpp>
 #include <boost/range/end.hpp>
-#include <boost/range/algorithm/find_if.hpp>
 #include <boost/iterator/transform_iterator.hpp>
-#include <boost/preprocessor/stringize.hpp>
 #include <yaml-cpp/yaml.h>
 
 #include <string>
@@ -38,27 +38,7 @@
 #include <cmath>
 #include <ctime>
 #include <cerrno>
-
-
-#ifndef FANCONTROL_PIDFILE
-#	define FANCONTROL_PIDFILE (1)
-#endif
-#if FANCONTROL_PIDFILE
-#	ifndef FANCONTROL_PIDFILE_ROOTONLY
-#		ifdef NDEBUG
-#			define FANCONTROL_PIDFILE_ROOTONLY (1)
-#		else
-#			define FANCONTROL_PIDFILE_ROOTONLY (0)
-#		endif
-#	endif
-#	ifndef FANCONTROL_PIDFILE_PATH
-#		if FANCONTROL_PIDFILE_ROOTONLY
-#			define FANCONTROL_PIDFILE_PATH /var/run/fancontrol.pid
-#		else
-#			define FANCONTROL_PIDFILE_PATH fancontrol.pid
-#		endif
-#	endif
-#endif
+#include <cstring>
 
 
 namespace fancontrol {
@@ -85,12 +65,31 @@ typedef config::ios_failure ios_failure;
 typedef std::string name_buffer_type;
 
 
+// whether an optional key is set, rather than left out or ~
+static bool is_given(const Node &node)
+{
+	return node.IsDefined() && !node.IsNull();
+}
+
+
+template <typename T>
+static bool parse_optional(const Node &node, T &value)
+{
+	if (!is_given(node))
+		return false;
+	node >> value;
+	return true;
+}
+
+
 shared_ptr<chip>
 config::parse_chip(const Node &node)
 {
 	name_buffer_type name;
 	node["name"] >> name;
-	shared_ptr<chip> chip(sensors->chip(name));
+	shared_ptr<chip> &chip = m_resolved.chips[name];
+	if (!chip)
+		chip = sensors->chip(name);
 	if (chip)
 		return chip;
 
@@ -101,16 +100,25 @@ config::parse_chip(const Node &node)
 shared_ptr<subfeature>
 config::parse_subfeature(const Node &node)
 {
+	resolved_names::subfeature_key key;
+	node["chip"]["name"] >> key.first;
+	node["input"] >> key.second;
+	shared_ptr<subfeature> &resolved = m_resolved.subfeatures[key];
+	if (resolved)
+		return resolved;
+
 	shared_ptr<chip> chip(parse_chip(node["chip"]));
 
-	name_buffer_type name_buf;
-	node["input"] >> name_buf;
+	const name_buffer_type &name_buf = key.second;
 	string_ref name(name_buf);
 
 	shared_ptr<feature> feat(chip->feature_consume_name(name));
 	if (feat) {
 		shared_ptr<subfeature> sfeat(feat->subfeature(name));
 		if (sfeat) {
+			// also switches it off again when a reload drops direct_read
+			sfeat->direct(direct_read);
+			resolved = sfeat;
 			return sfeat;
 		}
 	}
@@ -126,13 +134,23 @@ config::parse_subfeature(const Node &node)
 shared_ptr<pwm>
 config::parse_pwm(const Node &node)
 {
+	resolved_names::pwm_key key;
+	node["chip"]["name"] >> key.first;
+	node["output"] >> key.second;
+	shared_ptr<pwm> &resolved = m_resolved.pwms[key];
+	if (resolved)
+		return resolved;
+
 	shared_ptr<chip> chip(parse_chip(node["chip"]));
 
-	int idx; node["output"] >> idx;
+	const int idx = key.second;
 	errno = 0;
 	shared_ptr<pwm> pwm(chip->pwm(idx));
-	if (pwm)
+	if (pwm) {
+		pwm->keep_open(keep_open);
+		resolved = pwm;
 		return pwm;
+	}
 
 	std::ostringstream feature_name;
 	feature_name << pwm::Item::prefix() << idx;
@@ -147,18 +165,21 @@ shared_ptr<control>
 config::parse_simple_control(const Node &node)
 {
 	shared_ptr<subfeature> source(parse_subfeature(node["source"]));
-	controls_container::const_iterator it_ctrl = boost::find_if(controls,
-			bind(simple_bounded_control::source_comparator(), _1, cref(*source)));
 
-	if (it_ctrl == controls.end()) {
+	// Subfeature objects are shared while referenced, so their address
+	// identifies a source.
+	const std::pair<std::unordered_map<const subfeature*, controls_container::size_type>::iterator, bool>
+		r = m_simple_controls.insert(std::make_pair(source.get(), controls.size()));
+
+	if (r.second) {
 		simple_bounded_control::value_t min, max;
 		node["min"] >> min;
 		node["max"] >> max;
 		controls.push_back(static_pointer_cast<control>(
 				util::make_shared<simple_bounded_control>(source, min, max)));
-		it_ctrl = controls.end() - 1;
 	}
-	return *it_ctrl;
+	BOOST_ASSERT(simple_bounded_control::source_comparator()(controls[r.first->second], *source));
+	return controls[r.first->second];
 }
 
 
@@ -228,27 +249,30 @@ config::parse_fans(const Node &node)
 }
 
 
+void config::resolved_names::clear()
+{
+	chips.clear();
+	subfeatures.clear();
+	pwms.clear();
+}
+
+
 void config::interval(struct timespec *t) const
 {
-	double seconds;
-	t->tv_nsec = static_cast<long>(std::modf(m_interval, &seconds) * 1e+9);
-	t->tv_sec = static_cast<time_t>(seconds);
+	*t = util::to_timespec(m_interval);
 }
 
 
 config::config(istream &source, const shared_ptr<sensor_container> &sensors,
 	bool do_check)
 	: auto_reset(true)
+	, keep_open(false)
+	, direct_read(false)
+	, io_uring_sampler(false)
+	, telemetry_records(0)
 	, sensors(sensors)
+	, m_redundant_reads(0)
 {
-	if (!do_check) {
-#if FANCONTROL_PIDFILE
-		m_pidfile.reset(new util::pidfile(
-				string_ref(BOOST_PP_STRINGIZE(FANCONTROL_PIDFILE_PATH)),
-				FANCONTROL_PIDFILE_ROOTONLY));
-#endif
-	}
-
 	Node doc = YAML::Load(source);
 	const Node &interval_node = doc["interval"];
 	if (interval_node.Type() != NodeType::Null) {
@@ -258,7 +282,558 @@ config::config(istream &source, const shared_ptr<sensor_container> &sensors,
 		m_interval = 10;
 	}
 
+	const Node &keep_open_node = doc["keep_open"];
+	if (is_given(keep_open_node))
+		keep_open_node >> keep_open;
+
+	const Node &direct_read_node = doc["direct_read"];
+	if (is_given(direct_read_node))
+		direct_read_node >> direct_read;
+
+	const Node &sampler_node = doc["sampler"];
+	if (is_given(sampler_node)) {
+		string sampler;
+		sampler_node >> sampler;
+		if (sampler == "io_uring") {
+			io_uring_sampler = true;
+		} else if (sampler != "sync") {
+			BOOST_THROW_EXCEPTION(std::invalid_argument("Unknown sampler: " + sampler));
+		}
+	}
+
+	parse_optional(doc["metrics_socket"], metrics_socket);
+	parse_optional(doc["status_segment"], status_segment);
+
+	const Node &adaptive_node = doc["adaptive"];
+	if (is_given(adaptive_node))
+		parse_adaptive(adaptive_node);
+
+	const Node &telemetry_node = doc["telemetry"];
+	if (is_given(telemetry_node))
+		parse_telemetry(telemetry_node);
+
 	parse_fans(doc["fans"]);
+	m_simple_controls.clear();
+	m_resolved.clear();
+	finish(do_check);
+}
+
+
+config::config(const config_cache::image &image, const shared_ptr<sensor_container> &sensors,
+	bool do_check)
+	: auto_reset(true)
+	, sensors(sensors)
+	, m_redundant_reads(0)
+{
+	using namespace config_cache;
+	const file_header &h = image.header();
+	m_interval = h.interval;
+	keep_open = (h.flags & file_header::keep_open_flag) != 0;
+	direct_read = (h.flags & file_header::direct_read_flag) != 0;
+	io_uring_sampler = (h.flags & file_header::io_uring_flag) != 0;
+	metrics_socket = image.string(h.metrics_socket);
+	status_segment = image.string(h.status_segment);
+	telemetry_path = image.string(h.telemetry_path);
+	telemetry_records = static_cast<unsigned long>(h.telemetry_records);
+
+	if (h.flags & file_header::adaptive_flag) {
+		adaptive_interval::parameters params;
+		params.min = h.adaptive_min;
+		params.max = h.adaptive_max;
+		params.factor = h.adaptive_factor;
+		params.threshold = h.adaptive_threshold;
+		params.margin = h.adaptive_margin;
+		adaptive.configure(m_interval, params);
+	}
+
+	std::vector< shared_ptr<chip> > chips;
+	chips.reserve(h.chip_count);
+	for (const chip_record *c = image.chips(), *const end = c + h.chip_count; c != end; ++c) {
+		const chip::basic_type match = {
+			const_cast<char*>(image.string(c->prefix)), { c->bus_type, c->bus_nr }, c->addr, nullptr
+		};
+		chips.push_back(sensors->chip(match, true));
+		if (!chips.back()) {
+			BOOST_THROW_EXCEPTION(sensor_error(sensor_error::unparsable_chip_name)
+				<< sensor_error::chip_name(match.prefix));
+		}
+	}
+
+	std::vector< shared_ptr<subfeature> > sources;
+	sources.reserve(h.source_count);
+	for (const source_record *s = image.sources(), *const end = s + h.source_count; s != end; ++s) {
+		chip &ch = *chips[s->chip];
+		const shared_ptr<feature> feat(ch.feature(
+			static_cast<sensors_feature_type>(s->feature_type), s->feature_number));
+		shared_ptr<subfeature> sf;
+		if (feat)
+			sf = feat->subfeature(static_cast<sensors_subfeature_type>(s->subfeature_type));
+		if (!sf) {
+			BOOST_THROW_EXCEPTION(sensor_error("No such subfeature")
+				<< sensor_error::chip_name(ch.prefix().str()));
+		}
+		sf->direct(direct_read);
+		sources.push_back(sf);
+	}
+
+	std::vector< shared_ptr<pwm> > pwms;
+	pwms.reserve(h.pwm_count);
+	for (const pwm_record *p = image.pwms(), *const end = p + h.pwm_count; p != end; ++p) {
+		shared_ptr<pwm> valve(chips[p->chip]->pwm(p->number));
+		if (!valve) {
+			throw pwm_error("No such PWM port")
+				<< sensor_error::chip_name(chips[p->chip]->prefix().str());
+		}
+		valve->keep_open(keep_open);
+		pwms.push_back(valve);
+	}
+
+	const std::uint32_t *const children = image.children();
+	for (const control_record *c = image.controls(), *const end = c + h.control_count; c != end; ++c) {
+		if (c->source != control_record::npos) {
+			controls.push_back(static_pointer_cast<control>(
+				util::make_shared<simple_bounded_control>(sources[c->source], c->min, c->max)));
+		} else {
+			std::vector< shared_ptr<control> > deps;
+			for (std::uint32_t k = c->first_child; k != c->first_child + c->child_count; k++)
+				deps.push_back(controls[children[k]].ptr());
+			controls.push_back(static_pointer_cast<control>(
+				util::make_shared< aggregated_control<> >(deps.begin(), deps.end(), deps.size())));
+		}
+	}
+
+	for (const fan_record *f = image.fans(), *const end = f + h.fan_count; f != end; ++f) {
+		shared_ptr<fan> fan(make_shared<fan>());
+		fan->m_label.m_value = image.string(f->label);
+		fan->m_min_start = f->start;
+		fan->m_max_stop = f->stop;
+		fan->m_reset_rate = f->reset;
+		fan->m_gauge.m_value = sources[f->gauge];
+		fan->m_valve.m_value = pwms[f->valve];
+		if (f->control != control_record::npos)
+			fan->m_dependency = controls[f->control].ptr();
+		fans.push_back(fan);
+	}
+
+	finish(do_check);
+}
+
+
+void config::finish(bool do_check)
+{
+	if (keep_open || direct_read) {
+		// Every directly read source and every PWM attribute kept open holds
+		// a descriptor; large configurations exceed the default soft limit.
+		const int errnum = util::raise_file_descriptor_limit();
+		if (errnum != 0) {
+			std::clog << "Could not raise the file descriptor limit ("
+				<< std::strerror(errnum) << ')' << std::endl;
+		}
+	}
+
+	build_snapshot();
+	build_plan();
+
+	std::vector<string> fan_labels;
+	for (const fan_type &f : fans)
+		fan_labels.push_back(*f->m_label);
+	timings.setup(samples, fan_labels);
+
+	if (io_uring_sampler && !do_check)
+		samples.use_io_uring(true);
+
+	if (!telemetry_path.empty() && !do_check)
+		recorder.open(telemetry_path, telemetry_records, channels());
+	if (!status_segment.empty() && !do_check)
+		publisher.open(status_segment, channels());
+}
+
+
+void config::parse_adaptive(const Node &node)
+{
+	adaptive_interval::parameters params;
+	params.min = std::min(params.min, m_interval);
+	params.max = std::max(params.max, m_interval);
+
+	parse_optional(node["min"], params.min);
+	parse_optional(node["max"], params.max);
+	parse_optional(node["threshold"], params.threshold);
+	parse_optional(node["margin"], params.margin);
+	parse_optional(node["factor"], params.factor);
+
+	if (!(params.min > 0 && params.min <= m_interval && m_interval <= params.max))
+		BOOST_THROW_EXCEPTION(std::invalid_argument(
+			"The adaptive interval bounds must satisfy 0 < min <= interval <= max"));
+	if (!(params.threshold > 0 && params.factor > 1))
+		BOOST_THROW_EXCEPTION(std::invalid_argument(
+			"The adaptive interval needs a positive threshold and a factor above 1"));
+
+	adaptive.configure(m_interval, params);
+}
+
+
+void config::build_snapshot()
+{
+	for (const control_type &c : controls) {
+		const simple_bounded_control *const sc =
+			dynamic_cast<const simple_bounded_control*>(&c.ref());
+		if (sc)
+			samples.add(sc->source());
+	}
+	for (const fan_type &f : fans) {
+		samples.add(f->m_gauge.get());
+	}
+
+	samples.build();
+
+	for (control_type &c : controls) {
+		simple_bounded_control *const sc =
+			dynamic_cast<simple_bounded_control*>(&c.ref());
+		if (sc)
+			sc->sample(samples.find(*sc->source()));
+	}
+	for (fan_type &f : fans) {
+		f->m_gauge.m_sample = samples.find(*f->m_gauge.get());
+	}
+}
+
+
+static unsigned long count_reads(const control &c)
+{
+	const aggregated_control_base *const ac =
+		dynamic_cast<const aggregated_control_base*>(&c);
+	if (!ac)
+		return 1;
+
+	unsigned long n = 0;
+	for (aggregated_control_base::const_range_type s = ac->sources();
+		s.first != s.second; ++s.first)
+	{
+		n += count_reads(**s.first);
+	}
+	return n;
+}
+
+
+/*
+ * Besides lowering the controls, this estimates how many sensor readings a
+ * naive walk of every fan's control tree would take per tick beyond the
+ * snapshot's, for tick_statistics::estimated_saved_reads.
+ */
+void config::build_plan()
+{
+	plan.clear();
+	m_fan_nodes.clear();
+	m_fan_nodes.reserve(fans.size());
+	unsigned long reads = fans.size();  // one gauge per fan
+	for (const fan_type &f : fans) {
+		if (f->m_dependency) {
+			m_fan_nodes.push_back(plan.add(*f->m_dependency, samples));
+			reads += count_reads(*f->m_dependency);
+		} else {
+			m_fan_nodes.push_back(control_plan::npos);
+		}
+	}
+	BOOST_ASSERT(reads >= samples.size());
+	m_redundant_reads = reads - samples.size();
+
+	m_fan_sample_offsets.assign(1, 0);
+	m_fan_samples.clear();
+	std::vector<bool> reached;
+	for (const control_plan::index_type node : m_fan_nodes) {
+		if (node != control_plan::npos) {
+			reached.assign(plan.sources(), false);
+			plan.collect_sources(node, reached);
+			for (std::size_t k = 0; k < reached.size(); k++) {
+				if (reached[k])
+					m_fan_samples.push_back(plan.sample(k));
+			}
+		}
+		m_fan_sample_offsets.push_back(m_fan_samples.size());
+	}
+	m_fan_errors.assign(fans.size(), 0);
+}
+
+
+bool config::has_samples(fans_container::size_type i) const
+{
+	const snapshot::value_t *const values = samples.values();
+	for (std::size_t k = m_fan_sample_offsets[i]; k < m_fan_sample_offsets[i+1]; k++) {
+		if (std::isnan(values[m_fan_samples[k]]))
+			return false;
+	}
+	return true;
+}
+
+
+/*
+ * A failed write is retried every tick, but only changes are logged.
+ */
+void config::record_write(fans_container::size_type i, int errnum)
+{
+	if (errnum != 0)
+		stats.write_errors++;
+
+	if (errnum != m_fan_errors[i]) {
+		const fan &f = *fans[i];
+		if (errnum != 0) {
+			std::clog << "Couldn't set fan " << *f.m_label << " at "
+				<< f.m_valve.get()->path() << " (" << std::strerror(errnum) << ')' << std::endl;
+		} else {
+			std::clog << "Setting fan " << *f.m_label << " again" << std::endl;
+		}
+		m_fan_errors[i] = errnum;
+	}
+}
+
+
+/*
+ * Rates of sources are named after their sample, aggregate rates after the
+ * fans they drive.
+ */
+std::vector<string> config::rate_names() const
+{
+	std::vector<string> names;
+	names.reserve(plan.size());
+	for (std::size_t i = 0; i < plan.sources(); i++)
+		names.push_back(samples.name(plan.sample(i)));
+
+	std::ostringstream name;
+	for (std::size_t i = 0; i < plan.aggregates(); i++) {
+		const std::size_t slot = plan.sources() + i;
+		name.str(string());
+		for (fans_container::size_type k = 0; k < fans.size(); k++) {
+			if (m_fan_nodes[k] != control_plan::npos && plan.slot(m_fan_nodes[k]) == slot)
+				name << (name.tellp() > 0 ? "," : "") << *fans[k]->m_label;
+		}
+		if (name.tellp() <= 0)
+			name << "aggregate" << i;
+		names.push_back(name.str());
+	}
+	return names;
+}
+
+
+/*
+ * One channel per sample, per control rate of the plan, and per fan for its
+ * speed and written PWM value.
+ */
+telemetry::recorder::channels_container config::channels() const
+{
+	using telemetry::channel;
+	telemetry::recorder::channels_container channels;
+	channels.reserve(samples.size() + plan.size() + 2 * fans.size());
+	for (snapshot::size_type i = 0; i < samples.size(); i++)
+		channels.push_back(channel(telemetry::sample_channel, samples.name(i)));
+
+	for (const string &name : rate_names())
+		channels.push_back(channel(telemetry::rate_channel, name));
+
+	for (const fan_type &f : fans) {
+		channels.push_back(channel(telemetry::rpm_channel, *f->m_label + "/rpm"));
+		channels.push_back(channel(telemetry::pwm_channel, *f->m_label + "/pwm"));
+	}
+	return channels;
+}
+
+
+void config::write_channels(float *v) const
+{
+	const snapshot::value_t *const values = samples.values();
+	v = std::copy(values, values + samples.size(), v);
+	v = std::copy(plan.rates(), plan.rates() + plan.size(), v);
+	for (const fan_type &f : fans) {
+		*v++ = static_cast<float>(f->m_gauge.read());
+		*v++ = f->last_update() * static_cast<float>(pwm::pwm_max());
+	}
+}
+
+
+void config::parse_telemetry(const Node &node)
+{
+	node["path"] >> telemetry_path;
+	telemetry_records = 65536;
+	parse_optional(node["records"], telemetry_records);
+	if (telemetry_path.empty() || telemetry_records == 0) {
+		BOOST_THROW_EXCEPTION(std::invalid_argument(
+			"Telemetry needs a path and a positive number of records"));
+	}
+}
+
+
+void config::publish()
+{
+	if (recorder.is_open()) {
+		write_channels(recorder.begin_record());
+		recorder.commit_record();
+	}
+	if (publisher.is_open()) {
+		write_channels(publisher.begin_update());
+		publisher.commit_update(stats.ticks);
+	}
+}
+
+
+/*
+ * One tick is split into three stages: All sensor readings are sampled in
+ * one pass, then the control plan is evaluated against that snapshot and
+ * every fan derives its PWM value, and finally the resulting PWM values are
+ * written.
+ *
+ * Hardware errors don't throw here. A sensor that fails keeps its last
+ * reading; a fan whose control lacks one altogether runs at its reset rate.
+ * A failed write leaves the valve to be written again on the next tick.
+ */
+void config::update(bool force)
+{
+	const std::uint64_t start = util::monotonic_ns();
+
+	samples.sample();
+	const std::uint64_t sampled = util::monotonic_ns();
+	plan.evaluate(samples.values());
+
+	const bool complete = samples.failures() == 0;
+	for (fans_container::size_type i = 0; i < fans.size(); i++) {
+		const control_plan::index_type node = m_fan_nodes[i];
+		if (node != control_plan::npos) {
+			if (complete || has_samples(i)) {
+				fans[i]->evaluate(plan.rate(node));
+			} else {
+				fans[i]->evaluate(fans[i]->m_reset_rate);
+				stats.fallbacks++;
+			}
+		} else {
+			fans[i]->evaluate();
+		}
+	}
+	const std::uint64_t evaluated = util::monotonic_ns();
+
+	std::uint64_t committed = evaluated;
+	for (fans_container::size_type i = 0; i < fans.size(); i++) {
+		fan &f = *fans[i];
+		const fan::value_t last = f.last_update();
+		const int errnum = f.commit(force);
+		if (errnum != 0 || m_fan_errors[i] != 0)
+			record_write(i, errnum);
+		const std::uint64_t now = util::monotonic_ns();
+		// only actual writes
+		if (force || !(f.last_update() == last))
+			timings.fans[i].record(now - committed);
+		committed = now;
+	}
+
+	timings.sample.record(sampled - start);
+	timings.evaluate.record(evaluated - sampled);
+	timings.commit.record(committed - evaluated);
+	const std::uint64_t *const chip_durations = samples.chip_durations();
+	for (snapshot::size_type g = 0; g < samples.chips(); g++) {
+		if (chip_durations[g] != 0)
+			timings.chips[g].record(chip_durations[g]);
+	}
+	timings.tick.record(util::monotonic_ns() - start);
+
+	stats.ticks++;
+	stats.sensor_reads += samples.size();
+	stats.read_errors += samples.failures();
+	stats.estimated_saved_reads += m_redundant_reads;
+	publish();
+}
+
+
+static bool same_control(const control *a, const control *b)
+{
+	if (!a || !b)
+		return a == b;
+
+	const simple_bounded_control
+		*const sa = dynamic_cast<const simple_bounded_control*>(a),
+		*const sb = dynamic_cast<const simple_bounded_control*>(b);
+	if (sa || sb) {
+		return sa && sb && sa->source() == sb->source()
+			&& sa->m_lower_bound == sb->m_lower_bound
+			&& sa->m_upper_bound == sb->m_upper_bound;
+	}
+
+	const aggregated_control_base
+		*const aa = dynamic_cast<const aggregated_control_base*>(a),
+		*const ab = dynamic_cast<const aggregated_control_base*>(b);
+	if (!aa || !ab)
+		return false;
+	aggregated_control_base::const_range_type ra = aa->sources(), rb = ab->sources();
+	for (; ra.first != ra.second && rb.first != rb.second; ++ra.first, ++rb.first) {
+		if (!same_control(&**ra.first, &**rb.first))
+			return false;
+	}
+	return ra.first == ra.second && rb.first == rb.second;
+}
+
+
+static bool same_settings(const fan &a, const fan &b)
+{
+	return a.m_gauge.get() == b.m_gauge.get()
+		&& a.m_min_start == b.m_min_start
+		&& a.m_max_stop == b.m_max_stop
+		&& a.m_reset_rate == b.m_reset_rate
+		&& same_control(a.m_dependency.get(), b.m_dependency.get());
+}
+
+
+/*
+ * Both configurations resolved their chips, sensors and PWM outputs through
+ * the same container while the old one was alive, so equal sources are the
+ * same objects with the same open descriptors and compare by address.
+ */
+void config::take_over(config &old)
+{
+	BOOST_ASSERT(sensors == old.sensors);
+	std::vector<bool> kept(old.fans.size(), false);
+	unsigned unchanged = 0, changed = 0;
+	for (const fan_type &f : fans) {
+		for (fans_container::size_type i = 0; i < old.fans.size(); i++) {
+			const fan &o = *old.fans[i];
+			if (!kept[i] && **f->m_valve == **o.m_valve) {
+				f->take_over(o);
+				kept[i] = true;
+				(same_settings(*f, o) ? unchanged : changed)++;
+				break;
+			}
+		}
+	}
+
+	for (fans_container::size_type i = 0; i < old.fans.size(); i++) {
+		if (kept[i])
+			old.fans[i].reset();
+	}
+	old.reset_nothrow();
+	old.auto_reset = false;
+	stats = old.stats;
+
+	std::clog << "Reloaded the configuration: "
+		<< unchanged << " fans unchanged, " << changed << " changed, "
+		<< (fans.size() - unchanged - changed) << " added, "
+		<< (old.fans.size() - unchanged - changed) << " removed" << std::endl;
+}
+
+
+config::tick_statistics::tick_statistics()
+	: ticks(0)
+	, sensor_reads(0)
+	, estimated_saved_reads(0)
+	, read_errors(0)
+	, write_errors(0)
+	, fallbacks(0)
+{
+}
+
+
+std::ostream &operator<<(std::ostream &out, const config::tick_statistics &stats)
+{
+	return out << stats.ticks << " ticks, "
+		<< stats.sensor_reads << " sensor readings, "
+		<< stats.estimated_saved_reads << " saved by the snapshot (estimated), "
+		<< stats.read_errors << " failed, "
+		<< stats.write_errors << " failed PWM writes, "
+		<< stats.fallbacks << " fallbacks to the reset rate";
 }
 
 
@@ -284,6 +859,8 @@ void config::reset_nothrow()
 			(*it)->reset();
 		} catch (ios_failure &e) {
 			std::clog << "Could not reset PWM: " << (*it)->m_valve.get()->path() << std::endl;
+		} catch (io_error &e) {
+			std::clog << "Could not reset PWM: " << e.what() << std::endl;
 		}
 	}
 }
@@ -9,23 +9,24 @@
 #ifndef FANCONTROL_CONFIG_HPP_
 #define FANCONTROL_CONFIG_HPP_
 
-
-#ifndef FANCONTROL_PIDFILE
-#	define FANCONTROL_PIDFILE (1)
-#endif
-
-#if FANCONTROL_PIDFILE
-#	include "util/pidfile.hpp"
-#endif
-
+#include "snapshot.hpp"
+#include "control_plan.hpp"
+#include "adaptive_interval.hpp"
+#include "telemetry.hpp"
+#include "status.hpp"
+#include "config_cache.hpp"
+#include "tick_timings.hpp"
 #include "sensors++/exceptions.hpp"
 #include "util/ptr_wrapper.hpp"
 #include "util/static_allocator/static_vector.hpp"
 #include "util/memory.hpp"
 #include <yaml-cpp/exceptions.h>
+#include <boost/functional/hash.hpp>
 
 #include <memory>
 #include <vector>
+#include <string>
+#include <unordered_map>
 #include <iosfwd>
 
 
@@ -68,17 +69,52 @@ public:
 
 	config(istream &source, const shared_ptr<sensor_container> &sensors, bool do_check = false);
 
+	/*
+	 * Builds the configuration an image was compiled from, resolving its
+	 * chips, sources and outputs by number. Throws, if they don't resolve.
+	 */
+	config(const config_cache::image &image, const shared_ptr<sensor_container> &sensors,
+		bool do_check = false);
+
 	~config();
 
 	void reset();
 
+	void update(bool force = false);
+
+	/*
+	 * Takes over the fans of a configuration this one replaces, which must
+	 * share its sensor container: fans on the same PWM output continue from
+	 * the value last written, so they're only written once their value
+	 * changes, and the old configuration's other fans are reset.
+	 */
+	void take_over(config &old);
+
 	bool auto_reset;
 
+	bool keep_open;
+
+	bool direct_read;
+
+	bool io_uring_sampler;
+
+	// Unix socket for the metrics endpoint, if any
+	std::string metrics_socket;
+
+	// shared memory segment for the status of every tick, if any
+	std::string status_segment;
+
+	// telemetry file and its capacity, if any
+	std::string telemetry_path;
+	unsigned long telemetry_records;
+
 	double m_interval;
 
 	double interval() const;
 	void interval(struct timespec *t) const;
 
+	adaptive_interval adaptive;
+
 	shared_ptr<sensor_container> sensors;
 
 	typedef util::ptr_wrapper< shared_ptr<control> > control_type;
@@ -89,11 +125,61 @@ public:
 	typedef util::static_vector<fan_type, 8> fans_container;
 	fans_container fans;
 
-private:
-	shared_ptr<chip> parse_chip(const Node &node);
+	snapshot samples;
+
+	control_plan plan;
+
+	// the plan node of a fan's control, or control_plan::npos
+	control_plan::index_type fan_node(fans_container::size_type i) const;
+
+	// a name for every rate of the plan
+	std::vector<std::string> rate_names() const;
+
+	// one channel per sample, control rate, and fan speed and PWM value
+	telemetry::recorder::channels_container channels() const;
+
+	// the values of the channels after a tick
+	void write_channels(float *values) const;
+
+	// records every tick if configured
+	telemetry::recorder recorder;
+
+	// publishes every tick if configured
+	status::publisher publisher;
+
+	struct tick_statistics
+	{
+		tick_statistics();
+
+		unsigned long ticks;
+
+		// distinct sensor readings taken
+		unsigned long sensor_reads;
+
+		/*
+		 * Readings a walk of every fan's control tree would take on top of
+		 * sensor_reads, because a sensor is referenced more than once. This
+		 * is estimated from the shape of the configuration, not counted.
+		 */
+		unsigned long estimated_saved_reads;
+
+		// failed sensor readings and PWM writes
+		unsigned long read_errors, write_errors;
+
+		// fans driven at their reset rate for lack of a reading
+		unsigned long fallbacks;
+	};
+
+	tick_statistics stats;
 
+	tick_timings timings;
+
+	// resolves a source node like in the configuration, e.g. to map it to a sample
 	shared_ptr<subfeature> parse_subfeature(const Node &node);
 
+private:
+	shared_ptr<chip> parse_chip(const Node &node);
+
 	shared_ptr<pwm> parse_pwm(const Node &node);
 
 	shared_ptr<control> parse_simple_control(const Node &node);
@@ -106,16 +192,66 @@ private:
 
 	fans_container::size_type parse_fans(const Node &node);
 
+	void parse_adaptive(const Node &node);
+
+	void build_snapshot();
+
+	void build_plan();
+
+	void parse_telemetry(const Node &node);
+
+	// everything that follows the fans and controls, whatever their origin
+	void finish(bool do_check);
+
+	void publish();
+
+	// whether every source of a fan's control has been read at least once
+	bool has_samples(fans_container::size_type i) const;
+
+	void record_write(fans_container::size_type i, int errnum);
+
 	void reset_nothrow();
 
-#if FANCONTROL_PIDFILE
-	std::unique_ptr< util::pidfile > m_pidfile;
-#endif
+	// index of the control for each source, while parsing
+	std::unordered_map<const subfeature*, controls_container::size_type> m_simple_controls;
+
+	// chips, sources and outputs by name, while parsing, so that anchors and
+	// repeated references are resolved only once
+	struct resolved_names
+	{
+		typedef std::pair<std::string, std::string> subfeature_key;
+		typedef std::pair<std::string, int> pwm_key;
+
+		std::unordered_map<std::string, shared_ptr<chip> > chips;
+
+		std::unordered_map<subfeature_key, shared_ptr<subfeature>, boost::hash<subfeature_key> > subfeatures;
 
+		std::unordered_map<pwm_key, shared_ptr<pwm>, boost::hash<pwm_key> > pwms;
+
+		void clear();
+	};
+
+	resolved_names m_resolved;
+
+	std::vector<control_plan::index_type> m_fan_nodes;
+
+	// the samples of fan i's control are [m_fan_sample_offsets[i], m_fan_sample_offsets[i+1])
+	std::vector<std::size_t> m_fan_sample_offsets;
+
+	std::vector<snapshot::size_type> m_fan_samples;
+
+	// the result of each fan's last write
+	std::vector<int> m_fan_errors;
+
+	unsigned long m_redundant_reads;
 };
 
 
 
+std::ostream &operator<<(std::ostream &out, const config::tick_statistics &stats);
+
+
+
 // implementation =============================================================
 
 inline double config::interval() const
@@ -123,5 +259,11 @@ inline double config::interval() const
 	return m_interval;
 }
 
+
+inline control_plan::index_type config::fan_node(fans_container::size_type i) const
+{
+	return m_fan_nodes[i];
+}
+
 } /* namespace fancontrol */
 #endif /* FANCONTROL_CONFIG_HPP_ */
@@ -0,0 +1,492 @@
+/*
+ * config_cache.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "config_cache.hpp"
+#include "config.hpp"
+#include "control.hpp"
+#include "fan.hpp"
+#include "sensors++/chip.hpp"
+#include "sensors++/feature.hpp"
+#include "sensors++/subfeature.hpp"
+#include "sensors++/pwm.hpp"
+#include "util/exception.hpp"
+#include "util/assert.hpp"
+#include "util/hash.hpp"
+
+#include <boost/throw_exception.hpp>
+#include <boost/assert.hpp>
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <link.h>
+#include <elf.h>
+#include <unistd.h>
+
+
+namespace fancontrol {
+	namespace config_cache {
+
+using util::io_error;
+
+
+namespace {
+
+	// read by libsensors besides its default configuration file
+	const char sensors_config_dir[] = "/etc/sensors.d";
+
+
+	void throw_io_error(const char *what, const std::string &path, int errnum = errno)
+	{
+		BOOST_THROW_EXCEPTION(io_error()
+			<< io_error::what_t(what)
+			<< io_error::filename(path)
+			<< io_error::errno_code(errnum));
+	}
+
+
+	void throw_invalid(const std::string &path)
+	{
+		BOOST_THROW_EXCEPTION(std::runtime_error(
+			path + " is no compiled configuration of a supported version"));
+	}
+
+
+	inline std::size_t align(std::size_t n, std::size_t alignment)
+	{
+		return (n + alignment - 1) / alignment * alignment;
+	}
+
+
+	std::vector<std::string> list_directory(const std::string &path)
+	{
+		std::vector<std::string> names;
+		DIR *const dir = ::opendir(path.c_str());
+		if (dir) {
+			while (const struct dirent *const e = ::readdir(dir)) {
+				if (e->d_name[0] != '.')
+					names.push_back(e->d_name);
+			}
+			::closedir(dir);
+		}
+		std::sort(names.begin(), names.end());
+		return names;
+	}
+
+
+	std::uint64_t hash_file_identity(const char *path, std::uint64_t hash)
+	{
+		struct stat st;
+		if (::stat(path, &st) == 0) {
+			hash = util::fnv1a(&st.st_ino, sizeof(st.st_ino), hash);
+			hash = util::fnv1a(&st.st_size, sizeof(st.st_size), hash);
+			hash = util::fnv1a(&st.st_mtim, sizeof(st.st_mtim), hash);
+		}
+		return hash;
+	}
+
+
+	int find_build_id(struct dl_phdr_info *info, std::size_t, void *data)
+	{
+		std::string &id = *static_cast<std::string*>(data);
+		for (ElfW(Half) i = 0; i < info->dlpi_phnum && id.empty(); i++) {
+			const ElfW(Phdr) &ph = info->dlpi_phdr[i];
+			if (ph.p_type != PT_NOTE)
+				continue;
+			const char *p = reinterpret_cast<const char*>(info->dlpi_addr + ph.p_vaddr);
+			const char *const end = p + ph.p_memsz;
+			while (p + sizeof(ElfW(Nhdr)) <= end) {
+				const ElfW(Nhdr) &note = *reinterpret_cast<const ElfW(Nhdr)*>(p);
+				const char *const name = p + sizeof(note);
+				const char *const desc = name + align(note.n_namesz, 4);
+				if (note.n_type == NT_GNU_BUILD_ID && note.n_namesz == 4 &&
+					std::memcmp(name, "GNU", 4) == 0)
+				{
+					id.assign(desc, note.n_descsz);
+					break;
+				}
+				p = desc + align(note.n_descsz, 4);
+			}
+		}
+		// The executable comes first.
+		return 1;
+	}
+
+
+	/*
+	 * The image layout changes with the program but version_value rarely
+	 * does, so each build only trusts its own images: by its GNU build ID, or
+	 * by the identity of its executable if it was linked without one.
+	 */
+	std::uint64_t hash_build_id(std::uint64_t hash)
+	{
+		std::string id;
+		::dl_iterate_phdr(&find_build_id, &id);
+		return !id.empty() ?
+			util::fnv1a(id, hash) :
+			hash_file_identity("/proc/self/exe", hash);
+	}
+
+
+	// Collects the strings of an image and hands out their offsets.
+	class string_table
+	{
+	public:
+		string_table()
+			: m_data(1, '\0')
+		{
+		}
+
+		std::uint32_t add(const std::string &s)
+		{
+			if (s.empty())
+				return 0;
+			const std::pair<std::unordered_map<std::string, std::uint32_t>::iterator, bool> r =
+				m_offsets.insert(std::make_pair(s, static_cast<std::uint32_t>(m_data.size())));
+			if (r.second)
+				m_data.append(s.c_str(), s.size() + 1);
+			return r.first->second;
+		}
+
+		const std::string &data() const
+		{
+			return m_data;
+		}
+
+	private:
+		std::string m_data;
+
+		std::unordered_map<std::string, std::uint32_t> m_offsets;
+	};
+
+
+	template <typename T>
+	void append(std::string &out, const std::vector<T> &table)
+	{
+		out.append(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(T));
+	}
+
+}
+
+
+const char file_header::magic_value[8] = { 'F', 'C', '2', 'C', 'O', 'N', 'F', 0 };
+const std::uint32_t control_record::npos;
+
+
+layout::layout(const file_header &h)
+{
+	chips = align(sizeof(file_header), 8);
+	sources = chips + h.chip_count * sizeof(chip_record);
+	pwms = sources + h.source_count * sizeof(source_record);
+	controls = pwms + h.pwm_count * sizeof(pwm_record);
+	children = controls + h.control_count * sizeof(control_record);
+	fans = children + h.child_count * sizeof(std::uint32_t);
+	strings = fans + h.fan_count * sizeof(fan_record);
+	size = strings + h.strings_size;
+}
+
+
+bool file_header::valid() const
+{
+	return std::memcmp(magic, magic_value, sizeof(magic)) == 0
+		&& version == version_value
+		&& strings_size != 0
+		&& layout(*this).size == size;
+}
+
+
+/*
+ * Every chip contributes its identity and the hwmon device libsensors found
+ * it at, so this looks at nothing libsensors didn't already read during its
+ * initialisation. Entries are sorted, so only the topology counts, not the
+ * order the kernel lists it in. A chip whose features changed fails to
+ * resolve when the image is loaded anyway.
+ */
+std::uint64_t topology_fingerprint(const char *sensors_config)
+{
+	std::vector<std::string> entries;
+	const sensors::sensors_chip_name *c;
+	int nr = 0;
+	while ((c = sensors::sensors_get_detected_chips(nullptr, &nr)) != nullptr) {
+		std::string entry(c->prefix ? c->prefix : "");
+		entry += '\0';
+		entry.append(reinterpret_cast<const char*>(&c->bus), sizeof(c->bus));
+		entry.append(reinterpret_cast<const char*>(&c->addr), sizeof(c->addr));
+		if (c->path)
+			entry += c->path;
+		entries.push_back(entry);
+	}
+	std::sort(entries.begin(), entries.end());
+
+	std::uint64_t hash = util::fnv1a_basis;
+	for (const std::string &entry : entries)
+		hash = util::fnv1a(entry, hash);
+
+	if (sensors_config)
+		hash = hash_file_identity(sensors_config, hash);
+	for (const std::string &name : list_directory(sensors_config_dir)) {
+		hash = util::fnv1a(name, hash);
+		hash = hash_file_identity((std::string(sensors_config_dir) + '/' + name).c_str(), hash);
+	}
+
+	// drivers come with the kernel
+	struct utsname uts;
+	if (::uname(&uts) == 0)
+		hash = util::fnv1a(uts.release, std::strlen(uts.release), hash);
+
+	return hash_build_id(hash);
+}
+
+
+void write(const std::string &path, const config &cfg,
+	std::uint64_t source_hash, std::uint64_t topology_hash)
+{
+	using sensors::chip;
+	using sensors::feature;
+	using sensors::subfeature;
+	using sensors::pwm;
+
+	string_table strings;
+	std::vector<chip_record> chips;
+	std::vector<source_record> sources;
+	std::vector<pwm_record> pwms;
+	std::vector<control_record> controls;
+	std::vector<std::uint32_t> children;
+	std::vector<fan_record> fans;
+
+	std::unordered_map<const chip*, std::uint32_t> chip_index;
+	const auto add_chip = [&](const chip &c) -> std::uint32_t {
+		const std::pair<std::unordered_map<const chip*, std::uint32_t>::iterator, bool> r =
+			chip_index.insert(std::make_pair(&c, static_cast<std::uint32_t>(chips.size())));
+		if (r.second) {
+			const chip::basic_type &name = *c.get();
+			chip_record rec;
+			rec.prefix = strings.add(name.prefix);
+			rec.addr = name.addr;
+			rec.bus_type = name.bus.type;
+			rec.bus_nr = name.bus.nr;
+			chips.push_back(rec);
+		}
+		return r.first->second;
+	};
+
+	std::unordered_map<const subfeature*, std::uint32_t> source_index;
+	const auto add_source = [&](const subfeature &sf) -> std::uint32_t {
+		const std::pair<std::unordered_map<const subfeature*, std::uint32_t>::iterator, bool> r =
+			source_index.insert(std::make_pair(&sf, static_cast<std::uint32_t>(sources.size())));
+		if (r.second) {
+			const feature &feat = *sf.parent();
+			source_record rec;
+			rec.chip = add_chip(*feat.parent());
+			rec.feature_type = feat->type;
+			// chips key their features by the number in the name, e.g. temp2
+			const char *number = feat->name;
+			while (*number && !std::isdigit(static_cast<unsigned char>(*number)))
+				++number;
+			rec.feature_number = std::atoi(number);
+			rec.subfeature_type = sf->type;
+			sources.push_back(rec);
+		}
+		return r.first->second;
+	};
+
+	std::unordered_map<const control*, std::uint32_t> control_index;
+	for (const config::control_type &c : cfg.controls) {
+		control_record rec;
+		rec.source = control_record::npos;
+		rec.first_child = rec.child_count = 0;
+		rec.min = rec.max = 0;
+
+		const simple_bounded_control *const sc = dynamic_cast<const simple_bounded_control*>(&c.ref());
+		if (sc) {
+			rec.source = add_source(*sc->source());
+			rec.min = sc->m_lower_bound;
+			rec.max = sc->m_upper_bound;
+		} else {
+			const aggregated_control_base &ac = dynamic_cast<const aggregated_control_base&>(c.ref());
+			rec.first_child = static_cast<std::uint32_t>(children.size());
+			for (aggregated_control_base::const_range_type s = ac.sources(); s.first != s.second; ++s.first) {
+				const std::unordered_map<const control*, std::uint32_t>::const_iterator it =
+					control_index.find(s.first->get());
+				BOOST_ASSERT(it != control_index.end());  // children precede their parents
+				children.push_back(it->second);
+			}
+			rec.child_count = static_cast<std::uint32_t>(children.size()) - rec.first_child;
+		}
+		control_index.insert(std::make_pair(&c.ref(), static_cast<std::uint32_t>(controls.size())));
+		controls.push_back(rec);
+	}
+
+	std::unordered_map<const pwm*, std::uint32_t> pwm_index;
+	for (const config::fan_type &f : cfg.fans) {
+		fan_record rec;
+		rec.label = strings.add(*f->m_label);
+		rec.gauge = add_source(*f->m_gauge.get());
+
+		const pwm &valve = *f->m_valve.get();
+		const std::pair<std::unordered_map<const pwm*, std::uint32_t>::iterator, bool> r =
+			pwm_index.insert(std::make_pair(&valve, static_cast<std::uint32_t>(pwms.size())));
+		if (r.second) {
+			pwm_record p;
+			const shared_ptr<const chip> valve_chip(valve.chip());
+			p.chip = add_chip(*UTIL_CHECK_POINTER(valve_chip));
+			p.number = static_cast<std::uint32_t>(valve.number());
+			pwms.push_back(p);
+		}
+		rec.valve = r.first->second;
+
+		rec.control = f->m_dependency ?
+			control_index.at(f->m_dependency.get()) : control_record::npos;
+		rec.start = f->m_min_start;
+		rec.stop = f->m_max_stop;
+		rec.reset = f->m_reset_rate;
+		fans.push_back(rec);
+	}
+
+	file_header h;
+	std::memset(&h, 0, sizeof(h));
+	std::memcpy(h.magic, file_header::magic_value, sizeof(h.magic));
+	h.version = file_header::version_value;
+	h.source_hash = source_hash;
+	h.topology_hash = topology_hash;
+	h.interval = cfg.m_interval;
+	if (cfg.keep_open) h.flags |= file_header::keep_open_flag;
+	if (cfg.direct_read) h.flags |= file_header::direct_read_flag;
+	if (cfg.io_uring_sampler) h.flags |= file_header::io_uring_flag;
+	if (cfg.adaptive.enabled()) h.flags |= file_header::adaptive_flag;
+	h.metrics_socket = strings.add(cfg.metrics_socket);
+	h.status_segment = strings.add(cfg.status_segment);
+	h.telemetry_path = strings.add(cfg.telemetry_path);
+	h.telemetry_records = cfg.telemetry_records;
+	const adaptive_interval::parameters &params = cfg.adaptive.params();
+	h.adaptive_min = params.min;
+	h.adaptive_max = params.max;
+	h.adaptive_factor = params.factor;
+	h.adaptive_threshold = params.threshold;
+	h.adaptive_margin = params.margin;
+	h.chip_count = static_cast<std::uint32_t>(chips.size());
+	h.source_count = static_cast<std::uint32_t>(sources.size());
+	h.pwm_count = static_cast<std::uint32_t>(pwms.size());
+	h.control_count = static_cast<std::uint32_t>(controls.size());
+	h.child_count = static_cast<std::uint32_t>(children.size());
+	h.fan_count = static_cast<std::uint32_t>(fans.size());
+	h.strings_size = static_cast<std::uint32_t>(strings.data().size());
+
+	const layout l(h);
+	h.size = static_cast<std::uint32_t>(l.size);
+	std::string body;
+	body.reserve(l.size - l.chips);
+	append(body, chips);
+	append(body, sources);
+	append(body, pwms);
+	append(body, controls);
+	append(body, children);
+	append(body, fans);
+	body += strings.data();
+	BOOST_ASSERT(body.size() == l.size - l.chips);
+	h.checksum = util::fnv1a(body.data(), body.size());
+
+	std::string data(l.chips, '\0');
+	std::memcpy(&data[0], &h, sizeof(h));
+	data += body;
+
+	// a fresh name, so nothing planted in the directory is followed
+	std::string tmp_path(path + ".XXXXXX");
+	const int fd = ::mkostemp(&tmp_path[0], O_CLOEXEC);
+	if (fd < 0)
+		throw_io_error("Couldn't write the compiled configuration", tmp_path);
+	const bool written = ::fchmod(fd, 0644) == 0 &&
+		::write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size());
+	const int errnum = errno;
+	if (::close(fd) != 0 || !written || ::rename(tmp_path.c_str(), path.c_str()) != 0) {
+		::unlink(tmp_path.c_str());
+		throw_io_error("Couldn't write the compiled configuration", path, written ? errno : errnum);
+	}
+}
+
+
+image::image(const std::string &path)
+	: m_map(nullptr)
+	, m_map_size(0)
+{
+	const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		throw_io_error("Couldn't open the compiled configuration", path);
+
+	struct stat st;
+	void *map = MAP_FAILED;
+	int errnum = 0;
+	if (::fstat(fd, &st) != 0) {
+		errnum = errno;
+	} else if (static_cast<std::size_t>(st.st_size) >= sizeof(file_header)) {
+		map = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		errnum = errno;
+	}
+	::close(fd);
+	if (map == MAP_FAILED) {
+		if (errnum == 0)
+			throw_invalid(path);
+		throw_io_error("Couldn't map the compiled configuration", path, errnum);
+	}
+	m_map = static_cast<const unsigned char*>(map);
+	m_map_size = static_cast<std::size_t>(st.st_size);
+
+	const file_header &h = header();
+	const layout l(h);
+	bool ok = h.valid() && h.size == m_map_size
+		&& util::fnv1a(m_map + l.chips, l.size - l.chips) == h.checksum
+		&& string(0)[h.strings_size - 1] == '\0';
+
+	// Every reference must stay inside the image.
+	const auto str = [&h](std::uint32_t offset) { return offset < h.strings_size; };
+	ok = ok && str(h.metrics_socket) && str(h.status_segment) && str(h.telemetry_path);
+	for (std::uint32_t i = 0; ok && i < h.chip_count; i++)
+		ok = str(chips()[i].prefix);
+	for (std::uint32_t i = 0; ok && i < h.source_count; i++)
+		ok = sources()[i].chip < h.chip_count;
+	for (std::uint32_t i = 0; ok && i < h.pwm_count; i++)
+		ok = pwms()[i].chip < h.chip_count;
+	for (std::uint32_t i = 0; ok && i < h.control_count; i++) {
+		const control_record &c = controls()[i];
+		if (c.source != control_record::npos) {
+			ok = c.source < h.source_count;
+		} else {
+			ok = c.child_count != 0 && c.first_child <= h.child_count
+				&& c.child_count <= h.child_count - c.first_child;
+			for (std::uint32_t k = 0; ok && k < c.child_count; k++)
+				ok = children()[c.first_child + k] < i;
+		}
+	}
+	for (std::uint32_t i = 0; ok && i < h.fan_count; i++) {
+		const fan_record &f = fans()[i];
+		ok = str(f.label) && f.gauge < h.source_count && f.valve < h.pwm_count
+			&& (f.control == control_record::npos || f.control < h.control_count);
+	}
+
+	if (!ok) {
+		::munmap(const_cast<unsigned char*>(m_map), m_map_size);
+		throw_invalid(path);
+	}
+}
+
+
+image::~image()
+{
+	::munmap(const_cast<unsigned char*>(m_map), m_map_size);
+}
+
+	} /* namespace config_cache */
+} /* namespace fancontrol */
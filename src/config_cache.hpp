@@ -0,0 +1,270 @@
+/*
+ * config_cache.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef FANCONTROL_CONFIG_CACHE_HPP_
+#define FANCONTROL_CONFIG_CACHE_HPP_
+
+#include <boost/noncopyable.hpp>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+
+namespace fancontrol {
+
+class config;
+
+	namespace config_cache {
+
+/*
+ * The layout of a compiled configuration: a header with the scalar settings
+ * followed by tables of chips, sources, PWM outputs, controls, the child
+ * indices of aggregated controls and fans, and finally the string table.
+ * Tables refer to each other by index and to strings by offset into the
+ * string table, where 0 is the empty string.
+ *
+ * Chips are stored by their exact libsensors name and sources and outputs
+ * by number, so loading an image resolves them with direct lookups instead
+ * of parsing YAML and matching feature names. Controls are stored in the
+ * order of the configuration's controls; children precede their parents.
+ *
+ * An image is only valid for the YAML text and hwmon topology whose hashes
+ * it carries, in host byte order on the machine that wrote it.
+ */
+struct file_header
+{
+	static const char magic_value[8];
+	static const std::uint32_t version_value = 1;
+
+	enum flags_enum : std::uint32_t {
+		keep_open_flag = 1,
+		direct_read_flag = 2,
+		io_uring_flag = 4,
+		adaptive_flag = 8,
+	};
+
+	char magic[8];
+	std::uint32_t version;
+
+	// of the whole image
+	std::uint32_t size;
+
+	std::uint64_t source_hash, topology_hash;
+
+	// of everything after the header
+	std::uint64_t checksum;
+
+	double interval;
+	std::uint32_t flags;
+
+	// string offsets
+	std::uint32_t metrics_socket, status_segment, telemetry_path;
+	std::uint64_t telemetry_records;
+
+	double adaptive_min, adaptive_max, adaptive_factor;
+	float adaptive_threshold, adaptive_margin;
+
+	std::uint32_t chip_count, source_count, pwm_count, control_count, child_count, fan_count;
+	std::uint32_t strings_size;
+
+	// whether magic, version and table sizes fit; indices are checked on loading
+	bool valid() const;
+};
+
+
+struct chip_record
+{
+	std::uint32_t prefix;
+	std::int32_t addr;
+	std::int16_t bus_type, bus_nr;
+};
+
+
+struct source_record
+{
+	std::uint32_t chip;
+
+	// the feature number is the one in its name, e.g. 2 for temp2
+	std::int32_t feature_type, feature_number, subfeature_type;
+};
+
+
+struct pwm_record
+{
+	std::uint32_t chip;
+	std::uint32_t number;
+};
+
+
+struct control_record
+{
+	static const std::uint32_t npos = static_cast<std::uint32_t>(-1);
+
+	// npos for an aggregated control
+	std::uint32_t source;
+
+	// aggregated controls only, into the child table
+	std::uint32_t first_child, child_count;
+
+	// simple controls only
+	float min, max;
+};
+
+
+struct fan_record
+{
+	std::uint32_t label, gauge, valve;
+
+	// npos without dependencies
+	std::uint32_t control;
+
+	float start, stop, reset;
+};
+
+
+/*
+ * Hashes the chips libsensors detected, its configuration files, the kernel
+ * release and the program's build ID, so a changed device order, compute
+ * statement, kernel or program invalidates every image. libsensors must be
+ * initialised.
+ */
+std::uint64_t topology_fingerprint(const char *sensors_config);
+
+
+/*
+ * Writes the compiled form of a configuration. The file is replaced
+ * atomically, so a concurrent loader sees the old or the new image.
+ */
+void write(const std::string &path, const config &cfg,
+	std::uint64_t source_hash, std::uint64_t topology_hash);
+
+
+/*
+ * A compiled configuration mapped read-only. The constructor validates the
+ * image completely, so its tables can be used without further checks.
+ */
+class image
+	: boost::noncopyable
+{
+public:
+	explicit image(const std::string &path);
+
+	~image();
+
+	const file_header &header() const;
+
+	bool matches(std::uint64_t source_hash, std::uint64_t topology_hash) const;
+
+	const chip_record *chips() const;
+
+	const source_record *sources() const;
+
+	const pwm_record *pwms() const;
+
+	const control_record *controls() const;
+
+	const std::uint32_t *children() const;
+
+	const fan_record *fans() const;
+
+	const char *string(std::uint32_t offset) const;
+
+private:
+	template <typename T>
+	const T *table(std::size_t offset) const;
+
+	const unsigned char *m_map;
+
+	std::size_t m_map_size;
+};
+
+
+// offsets of the tables of an image with the header's counts
+struct layout
+{
+	explicit layout(const file_header &h);
+
+	std::size_t chips, sources, pwms, controls, children, fans, strings, size;
+};
+
+
+
+// implementations ============================================================
+
+inline
+const file_header &image::header() const
+{
+	return *reinterpret_cast<const file_header*>(m_map);
+}
+
+
+inline
+bool image::matches(std::uint64_t source_hash, std::uint64_t topology_hash) const
+{
+	return header().source_hash == source_hash && header().topology_hash == topology_hash;
+}
+
+
+template <typename T>
+inline
+const T *image::table(std::size_t offset) const
+{
+	return reinterpret_cast<const T*>(m_map + offset);
+}
+
+
+inline
+const chip_record *image::chips() const
+{
+	return table<chip_record>(layout(header()).chips);
+}
+
+
+inline
+const source_record *image::sources() const
+{
+	return table<source_record>(layout(header()).sources);
+}
+
+
+inline
+const pwm_record *image::pwms() const
+{
+	return table<pwm_record>(layout(header()).pwms);
+}
+
+
+inline
+const control_record *image::controls() const
+{
+	return table<control_record>(layout(header()).controls);
+}
+
+
+inline
+const std::uint32_t *image::children() const
+{
+	return table<std::uint32_t>(layout(header()).children);
+}
+
+
+inline
+const fan_record *image::fans() const
+{
+	return table<fan_record>(layout(header()).fans);
+}
+
+
+inline
+const char *image::string(std::uint32_t offset) const
+{
+	return table<char>(layout(header()).strings) + offset;
+}
+
+	} /* namespace config_cache */
+} /* namespace fancontrol */
+#endif /* FANCONTROL_CONFIG_CACHE_HPP_ */
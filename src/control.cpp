@@ -32,13 +32,13 @@ bounded_control::~bounded_control()
 
 value_t bounded_control::convert_rate(value_t raw_value) const
 {
-	return util::clip<const value_t>((raw_value - m_lower_bound) / (m_upper_bound - m_lower_bound), 0, 1);
+	return util::clip<const value_t>(position(raw_value), 0, 1);
 }
 
 
 value_t simple_bounded_control::rate_impl() const
 {
-	double value = m_source->value();
+	const double value = m_sample ? *m_sample : m_source->value();
 	value_t rate = (this->*m_rate_converter)(static_cast<value_t>(value));
 	//UTIL_LOG(5, "Reading from " << *m_source << ':' << ' ' << value << '=' << '>' << rate);
 	return rate;
@@ -73,6 +73,7 @@ simple_bounded_control::simple_bounded_control(
 		rate_conversion_fun_t rate_converter)
 	: bounded_control(rate_converter)
 	, m_source(check_source_type(source))
+	, m_sample(nullptr)
 {
 }
 
@@ -82,6 +83,7 @@ simple_bounded_control::simple_bounded_control(
 		rate_conversion_fun_t rate_converter)
 	: bounded_control(lower_bound, upper_bound, rate_converter)
 	, m_source(check_source_type(source))
+	, m_sample(nullptr)
 {
 }
 
@@ -94,6 +96,7 @@ simple_bounded_control::~simple_bounded_control()
 void simple_bounded_control::source(const shared_ptr<const SF> &source)
 {
 	m_source = check_source_type(source);
+	m_sample = nullptr;
 }
 
 
@@ -73,6 +73,8 @@ public:
 
 	value_t convert_rate(value_t raw_value) const;
 
+	value_t position(value_t raw_value) const;
+
 	rate_conversion_fun_t m_rate_converter;
 
 	value_t m_lower_bound, m_upper_bound;
@@ -99,6 +101,10 @@ public:
 
 	void source(const shared_ptr<const SF> &source);
 
+	const double *sample() const;
+
+	void sample(const double *sample);
+
 	struct source_comparator
 		: std::binary_function<const control&, const SF&, bool>
 	{
@@ -115,6 +121,8 @@ private:
 
 	shared_ptr<const SF> m_source;
 
+	const double *m_sample;
+
 	friend struct source_comparator;
 };
 
@@ -207,6 +215,13 @@ bounded_control::bounded_control(
 { }
 
 
+inline
+bounded_control::value_t bounded_control::position(value_t raw_value) const
+{
+	return (raw_value - m_lower_bound) / (m_upper_bound - m_lower_bound);
+}
+
+
 inline
 const shared_ptr<const simple_bounded_control::SF> &
 simple_bounded_control::source() const
@@ -216,6 +231,20 @@ simple_bounded_control::source() const
 }
 
 
+inline
+const double *simple_bounded_control::sample() const
+{
+	return m_sample;
+}
+
+
+inline
+void simple_bounded_control::sample(const double *sample)
+{
+	m_sample = sample;
+}
+
+
 template <std::size_t S, class E>
 aggregated_control<S,E>::~aggregated_control()
 { }
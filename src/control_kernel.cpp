@@ -0,0 +1,149 @@
+/*
+ * control_kernel.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "control_kernel.hpp"
+
+#if defined(__AVX2__)
+#	include <immintrin.h>
+#	define FANCONTROL_KERNEL_NAME "avx2"
+#elif defined(__SSE2__)
+#	include <emmintrin.h>
+#	define FANCONTROL_KERNEL_NAME "sse2"
+#else
+#	define FANCONTROL_KERNEL_NAME "scalar"
+#endif
+
+/*
+ * With -ffast-math, GCC replaces vector float divisions by a reciprocal
+ * estimate and a Newton-Raphson step, which is up to 2 ulp off. It only does
+ * so without trapping math, so re-enabling it here keeps every division
+ * exact like the scalar division in bounded_control::convert_rate().
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#	pragma GCC optimize("trapping-math")
+#endif
+
+
+namespace fancontrol {
+	namespace kernel {
+
+namespace {
+
+	/*
+	 * The element-wise operations in the argument order of std::max and
+	 * std::min as used by util::clip: max(0, x) yields x unless 0 > x and
+	 * min(1, x) yields x unless 1 < x. _mm_max_ps(a, b) and _mm_min_ps(a, b)
+	 * and their AVX counterparts return b unless a > b resp. a < b, which
+	 * matches when called with the constant first.
+	 */
+	inline float convert_rate(float raw, float lower, float range)
+	{
+		const float position = (raw - lower) / range;
+		const float clipped = (position < 0.f) ? 0.f : position;
+		return (1.f < clipped) ? 1.f : clipped;
+	}
+
+}
+
+
+void gather(const double *samples, const std::uint32_t *index, float *out, std::size_t n)
+{
+	std::size_t i = 0;
+#if defined(__AVX2__)
+	for (; i + 4 <= n; i += 4) {
+		const __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(index + i));
+		_mm_storeu_ps(out + i, _mm256_cvtpd_ps(_mm256_i32gather_pd(samples, idx, 8)));
+	}
+#endif
+	for (; i < n; i++)
+		out[i] = static_cast<float>(samples[index[i]]);
+}
+
+
+void convert_rates(const float *raw, const float *lower, const float *range,
+	float *rates, std::size_t n)
+{
+	std::size_t i = 0;
+#if defined(__AVX2__)
+	const __m256 zero8 = _mm256_setzero_ps(), one8 = _mm256_set1_ps(1.f);
+	for (; i + 8 <= n; i += 8) {
+		const __m256 position = _mm256_div_ps(
+			_mm256_sub_ps(_mm256_loadu_ps(raw + i), _mm256_loadu_ps(lower + i)),
+			_mm256_loadu_ps(range + i));
+		_mm256_storeu_ps(rates + i,
+			_mm256_min_ps(one8, _mm256_max_ps(zero8, position)));
+	}
+#endif
+#if defined(__SSE2__)
+	const __m128 zero4 = _mm_setzero_ps(), one4 = _mm_set1_ps(1.f);
+	for (; i + 4 <= n; i += 4) {
+		const __m128 position = _mm_div_ps(
+			_mm_sub_ps(_mm_loadu_ps(raw + i), _mm_loadu_ps(lower + i)),
+			_mm_loadu_ps(range + i));
+		_mm_storeu_ps(rates + i, _mm_min_ps(one4, _mm_max_ps(zero4, position)));
+	}
+#endif
+	for (; i < n; i++)
+		rates[i] = convert_rate(raw[i], lower[i], range[i]);
+}
+
+
+/*
+ * The maximum of values that are not NaN does not depend on the order of
+ * comparison, so the lanes may be reduced in any order.
+ */
+float max(const float *values, const std::uint32_t *index, std::size_t n)
+{
+	if (n == 0)
+		return 0;
+
+	float m = values[index[0]];
+	std::size_t i = 1;
+#if defined(__AVX2__)
+	if (n >= 9) {
+		__m256 acc = _mm256_i32gather_ps(values,
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + 1)), 4);
+		for (i = 9; i + 8 <= n; i += 8) {
+			acc = _mm256_max_ps(acc, _mm256_i32gather_ps(values,
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + i)), 4));
+		}
+		__m128 acc4 = _mm_max_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+		acc4 = _mm_max_ps(acc4, _mm_movehl_ps(acc4, acc4));
+		acc4 = _mm_max_ss(acc4, _mm_shuffle_ps(acc4, acc4, 1));
+		const float v = _mm_cvtss_f32(acc4);
+		if (v > m)
+			m = v;
+	}
+#elif defined(__SSE2__)
+	if (n >= 5) {
+		__m128 acc = _mm_set_ps(values[index[4]], values[index[3]], values[index[2]], values[index[1]]);
+		for (i = 5; i + 4 <= n; i += 4) {
+			acc = _mm_max_ps(acc, _mm_set_ps(
+				values[index[i+3]], values[index[i+2]], values[index[i+1]], values[index[i]]));
+		}
+		acc = _mm_max_ps(acc, _mm_movehl_ps(acc, acc));
+		acc = _mm_max_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+		const float v = _mm_cvtss_f32(acc);
+		if (v > m)
+			m = v;
+	}
+#endif
+	for (; i < n; i++) {
+		const float v = values[index[i]];
+		if (v > m)
+			m = v;
+	}
+	return m;
+}
+
+
+const char *name()
+{
+	return FANCONTROL_KERNEL_NAME;
+}
+
+	} /* namespace kernel */
+} /* namespace fancontrol */
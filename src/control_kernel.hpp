@@ -0,0 +1,43 @@
+/*
+ * control_kernel.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef FANCONTROL_CONTROL_KERNEL_HPP_
+#define FANCONTROL_CONTROL_KERNEL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace fancontrol {
+	namespace kernel {
+
+/*
+ * The array operations behind control_plan::evaluate(). They are
+ * implemented with AVX2 or SSE2, whichever the target architecture offers
+ * (e.g. with -march=native), or with plain loops otherwise.
+ *
+ * Every variant performs the same IEEE operations per element as the scalar
+ * bounded_control::convert_rate() (subtract, divide, clip) and picks the
+ * same maximum as aggregated_control_base::rate_impl(), so results are
+ * bit-identical for all rates that are not NaN.
+ */
+
+// out[i] = samples[index[i]], converted to float
+void gather(const double *samples, const std::uint32_t *index, float *out, std::size_t n);
+
+// rates[i] = clip((raw[i] - lower[i]) / range[i], 0, 1)
+void convert_rates(const float *raw, const float *lower, const float *range,
+	float *rates, std::size_t n);
+
+// maximum of values[index[i]], or 0 if n == 0
+float max(const float *values, const std::uint32_t *index, std::size_t n);
+
+const char *name();
+
+	} /* namespace kernel */
+} /* namespace fancontrol */
+#endif /* FANCONTROL_CONTROL_KERNEL_HPP_ */
@@ -0,0 +1,170 @@
+/*
+ * control_plan.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "control_plan.hpp"
+#include "control_kernel.hpp"
+#include "snapshot.hpp"
+#include "sensors++/subfeature.hpp"
+#include "util/exception.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace fancontrol {
+
+typedef control_plan::value_t value_t;
+typedef control_plan::index_type index_type;
+
+const index_type control_plan::npos;
+const index_type control_plan::aggregate_flag;
+
+
+control_plan::control_plan()
+	: m_child_offsets(1, 0)
+	, m_dirty(false)
+{
+}
+
+
+void control_plan::clear()
+{
+	m_samples.clear();
+	m_lower_bounds.clear();
+	m_upper_bounds.clear();
+	m_ranges.clear();
+	m_raw.clear();
+	m_child_offsets.assign(1, 0);
+	m_children.clear();
+	m_child_slots.clear();
+	m_rates.clear();
+	m_lowered.clear();
+	m_dirty = false;
+}
+
+
+index_type control_plan::add_source(std::size_t sample, value_t lower_bound, value_t upper_bound)
+{
+	BOOST_ASSERT(m_samples.size() < aggregate_flag);
+	BOOST_ASSERT(sample <= static_cast<std::size_t>(INT32_MAX));
+	m_samples.push_back(static_cast<index_type>(sample));
+	m_lower_bounds.push_back(lower_bound);
+	m_upper_bounds.push_back(upper_bound);
+	m_ranges.push_back(upper_bound - lower_bound);
+	m_dirty = true;
+	return static_cast<index_type>(m_samples.size() - 1);
+}
+
+
+index_type control_plan::add_aggregate(const index_type *first, const index_type *last)
+{
+	const index_type node = static_cast<index_type>(aggregates()) | aggregate_flag;
+	for (; first != last; ++first) {
+		BOOST_ASSERT((*first & aggregate_flag) ?
+			(*first & ~aggregate_flag) < aggregates() : *first < sources());
+		m_children.push_back(*first);
+	}
+	m_child_offsets.push_back(static_cast<index_type>(m_children.size()));
+	m_dirty = true;
+	return node;
+}
+
+
+/*
+ * Lowers a control and, recursively, its sources. Controls shared between
+ * several parents are only added once.
+ */
+index_type control_plan::add(const control &c, const snapshot &samples)
+{
+	const std::unordered_map<const control*, index_type>::const_iterator it =
+		m_lowered.find(&c);
+	if (it != m_lowered.end())
+		return it->second;
+
+	index_type node;
+	if (const simple_bounded_control *const sc =
+		dynamic_cast<const simple_bounded_control*>(&c))
+	{
+		if (sc->m_rate_converter != &bounded_control::convert_rate)
+			BOOST_THROW_EXCEPTION(std::invalid_argument("Unsupported rate conversion"));
+		const std::size_t sample = samples.index(*sc->source());
+		if (sample == snapshot::npos)
+			BOOST_THROW_EXCEPTION(std::invalid_argument("Control source not sampled"));
+		node = add_source(sample, sc->m_lower_bound, sc->m_upper_bound);
+	}
+	else if (const aggregated_control_base *const ac =
+		dynamic_cast<const aggregated_control_base*>(&c))
+	{
+		std::vector<index_type> children;
+		for (aggregated_control_base::const_range_type s = ac->sources();
+			s.first != s.second; ++s.first)
+		{
+			children.push_back(add(*UTIL_CHECK_POINTER(*s.first), samples));
+		}
+		node = add_aggregate(children.data(), children.data() + children.size());
+	}
+	else
+	{
+		BOOST_THROW_EXCEPTION(std::invalid_argument("Unsupported control type"));
+	}
+
+	m_lowered.insert(std::make_pair(&c, node));
+	return node;
+}
+
+
+void control_plan::collect_sources(index_type node, std::vector<bool> &sources) const
+{
+	if (node & aggregate_flag) {
+		const index_type i = node & ~aggregate_flag;
+		for (index_type k = m_child_offsets[i]; k < m_child_offsets[i+1]; k++)
+			collect_sources(m_children[k], sources);
+	} else {
+		sources.resize(std::max(sources.size(), this->sources()));
+		sources[node] = true;
+	}
+}
+
+
+void control_plan::layout()
+{
+	m_child_slots.resize(m_children.size());
+	std::transform(m_children.begin(), m_children.end(), m_child_slots.begin(),
+		[this](index_type node) { return slot(node); });
+	m_raw.assign(sources(), 0);
+	m_rates.assign(size(), 0);
+	m_dirty = false;
+}
+
+
+/*
+ * The kernels mirror bounded_control::convert_rate() and
+ * aggregated_control_base::rate_impl() operation by operation, so both
+ * paths yield identical rates.
+ */
+void control_plan::evaluate(const double *samples)
+{
+	if (m_dirty)
+		layout();
+
+	const std::size_t n_sources = sources();
+	kernel::gather(samples, m_samples.data(), m_raw.data(), n_sources);
+	kernel::convert_rates(m_raw.data(), m_lower_bounds.data(), m_ranges.data(),
+		m_rates.data(), n_sources);
+
+	value_t *const rates = m_rates.data();
+	const index_type *const offsets = m_child_offsets.data();
+	const index_type *const children = m_child_slots.data();
+	const std::size_t n_aggregates = aggregates();
+	for (std::size_t i = 0; i < n_aggregates; i++) {
+		rates[n_sources + i] =
+			kernel::max(rates, children + offsets[i], offsets[i+1] - offsets[i]);
+	}
+}
+
+} /* namespace fancontrol */
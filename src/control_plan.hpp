@@ -0,0 +1,200 @@
+/*
+ * control_plan.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef FANCONTROL_CONTROL_PLAN_HPP_
+#define FANCONTROL_CONTROL_PLAN_HPP_
+
+#include "control.hpp"
+#include <unordered_map>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace fancontrol {
+
+class snapshot;
+
+
+/*
+ * A control graph lowered into flat arrays.
+ *
+ * Bounded sources hold the index of their reading in a sample array and
+ * their bounds; aggregates hold a range of child nodes in one shared array.
+ * Nodes can only refer to nodes added before them, so the order of addition
+ * is a topological order. evaluate() computes all source rates in one pass
+ * and then all aggregate rates in another, without virtual calls or
+ * reference counting, using the vectorized routines in control_kernel.hpp.
+ *
+ * Node handles returned by the add functions stay valid until clear(). The
+ * rates of sources occupy the first slots of rates(), followed by those of
+ * the aggregates.
+ */
+class control_plan
+{
+public:
+	typedef control::value_t value_t;
+
+	typedef std::uint32_t index_type;
+
+	static const index_type npos = static_cast<index_type>(-1);
+
+	control_plan();
+
+	void clear();
+
+	index_type add_source(std::size_t sample, value_t lower_bound, value_t upper_bound);
+
+	index_type add_aggregate(const index_type *first, const index_type *last);
+
+	index_type add(const control &c, const snapshot &samples);
+
+	void evaluate(const double *samples);
+
+	value_t rate(index_type node) const;
+
+	// position of a node's rate in rates()
+	index_type slot(index_type node) const;
+
+	const value_t *rates() const;
+
+	std::size_t size() const;
+
+	std::size_t sources() const;
+
+	std::size_t aggregates() const;
+
+	// the sample read by a source
+	std::size_t sample(std::size_t source) const;
+
+	value_t lower_bound(std::size_t source) const;
+
+	value_t upper_bound(std::size_t source) const;
+
+	void bounds(std::size_t source, value_t lower_bound, value_t upper_bound);
+
+	// Marks the sources a node depends on.
+	void collect_sources(index_type node, std::vector<bool> &sources) const;
+
+	value_t position(std::size_t source, const double *samples) const;
+
+private:
+	static const index_type aggregate_flag = static_cast<index_type>(1) << 31;
+
+	void layout();
+
+	// sources
+	std::vector<index_type> m_samples;
+
+	std::vector<value_t> m_lower_bounds, m_upper_bounds, m_ranges;
+
+	std::vector<value_t> m_raw;
+
+	// aggregates
+	std::vector<index_type> m_child_offsets;
+
+	std::vector<index_type> m_children;
+
+	std::vector<index_type> m_child_slots;
+
+	// results
+	std::vector<value_t> m_rates;
+
+	bool m_dirty;
+
+	std::unordered_map<const control*, index_type> m_lowered;
+};
+
+
+
+// implementations ========================================
+
+inline
+control_plan::index_type control_plan::slot(index_type node) const
+{
+	return (node & aggregate_flag) ?
+		static_cast<index_type>(m_samples.size()) + (node & ~aggregate_flag) :
+		node;
+}
+
+
+inline
+control_plan::value_t control_plan::rate(index_type node) const
+{
+	BOOST_ASSERT(!m_dirty);
+	return m_rates[slot(node)];
+}
+
+
+inline
+const control_plan::value_t *control_plan::rates() const
+{
+	BOOST_ASSERT(!m_dirty);
+	return m_rates.data();
+}
+
+
+inline
+std::size_t control_plan::sources() const
+{
+	return m_samples.size();
+}
+
+
+inline
+std::size_t control_plan::sample(std::size_t source) const
+{
+	return m_samples[source];
+}
+
+
+inline
+control_plan::value_t control_plan::lower_bound(std::size_t source) const
+{
+	return m_lower_bounds[source];
+}
+
+
+inline
+control_plan::value_t control_plan::upper_bound(std::size_t source) const
+{
+	return m_upper_bounds[source];
+}
+
+
+inline
+void control_plan::bounds(std::size_t source, value_t lower_bound, value_t upper_bound)
+{
+	m_lower_bounds[source] = lower_bound;
+	m_upper_bounds[source] = upper_bound;
+	m_ranges[source] = upper_bound - lower_bound;
+}
+
+
+inline
+std::size_t control_plan::aggregates() const
+{
+	return m_child_offsets.size() - 1;
+}
+
+
+inline
+std::size_t control_plan::size() const
+{
+	return sources() + aggregates();
+}
+
+
+inline
+control_plan::value_t control_plan::position(std::size_t source, const double *samples) const
+{
+	return (static_cast<value_t>(samples[m_samples[source]]) - m_lower_bounds[source]) /
+		m_ranges[source];
+}
+
+} /* namespace fancontrol */
+#endif /* FANCONTROL_CONTROL_PLAN_HPP_ */
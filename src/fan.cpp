@@ -10,6 +10,7 @@
 #include "sensors++/subfeature.hpp"
 #include "sensors++/pwm.hpp"
 
+#include <boost/throw_exception.hpp>
 #include <boost/assert.hpp>
 #include <limits>
 #include <cmath>
@@ -30,6 +31,7 @@ fan::fan()
 	, m_max_stop(0.5f)
 	, m_reset_rate(1.0f)
 	, m_last_update(std::numeric_limits<value_t>::quiet_NaN())
+	, m_pending(std::numeric_limits<value_t>::quiet_NaN())
 {
 }
 
@@ -40,7 +42,19 @@ bool fan::gauge_type_guard::check(const SF *gauge)
 }
 
 
+fan::gauge_wrapper::gauge_wrapper()
+	: m_sample(nullptr)
+{
+}
+
+
 double fan::gauge_wrapper::read() const
+{
+	return m_sample ? *m_sample : read_live();
+}
+
+
+double fan::gauge_wrapper::read_live() const
 {
 	return m_value->value();
 }
@@ -58,45 +72,84 @@ value_t fan::valve_wrapper::read()
 }
 
 
-void fan::valve_wrapper::write(value_t value)
+int fan::valve_wrapper::write(value_t value)
 {
-	m_value->value(value);
+	return m_value->write(value);
 }
 
 
-value_t fan::effective_value(value_t value) const
+value_t fan::effective_value(value_t value, bool live_gauge) const
 {
 	BOOST_ASSERT(value >= 0);
 	if (value > 0 && value < m_min_start) {
-		if (m_gauge.read() == 0) {
-			value = m_min_start;
-		} else if (value < m_max_stop) {
-			value = m_max_stop;
-		}
+		const double gauge = live_gauge ? m_gauge.read_live() : m_gauge.read();
+		return effective_value(value, gauge, m_min_start, m_max_stop);
 	}
 	return value;
 }
 
 
-void fan::update_valve(bool force, value_t value)
+bool fan::needs_update(value_t value, value_t last)
 {
-	if (force || !(std::abs(value - m_last_update) < (2.f * static_cast<value_t>(pwm::pwm_max_inverse()))))
+	return !(std::abs(value - last) < (2.f * static_cast<value_t>(pwm::pwm_max_inverse())));
+}
+
+
+int fan::update_valve(bool force, value_t value)
+{
+	if (force || needs_update(value, m_last_update))
 	{
-		m_valve.write(value);
+		const int errnum = m_valve.write(value);
+		if (errnum != 0)
+			return errnum;
 		m_last_update = value;
 	}
+	return 0;
 }
 
 
 void fan::update_valve(bool force)
 {
-	update_valve(force, effective_value(UTIL_CHECK_POINTER(m_dependency)->rate()));
+	evaluate();
+	commit(force);
+}
+
+
+value_t fan::evaluate()
+{
+	return evaluate(UTIL_CHECK_POINTER(m_dependency)->rate());
+}
+
+
+value_t fan::evaluate(value_t rate)
+{
+	return m_pending = effective_value(rate);
+}
+
+
+int fan::commit(bool force)
+{
+	BOOST_ASSERT(!std::isnan(m_pending));
+	return update_valve(force, m_pending);
 }
 
 
 void fan::reset()
 {
-	update_valve(true, effective_value(m_reset_rate));
+	const int errnum = update_valve(true, effective_value(m_reset_rate, true));
+	if (errnum != 0) {
+		BOOST_THROW_EXCEPTION(io_error()
+			<< io_error::what_t("Could not write PWM attribute")
+			<< io_error::filename(m_valve.get()->path())
+			<< io_error::errno_code(errnum));
+	}
+}
+
+
+void fan::take_over(const fan &o)
+{
+	BOOST_ASSERT(**m_valve == **o.m_valve);
+	m_last_update = o.m_last_update;
 }
 
 
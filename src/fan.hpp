@@ -60,8 +60,34 @@ public:
 
 	void update_valve(bool force = false);
 
+	value_t evaluate();
+
+	value_t evaluate(value_t rate);
+
+	/*
+	 * Returns 0 or the errno value of a failed write, which is retried on the
+	 * next commit, as the valve didn't take the value.
+	 */
+	int commit(bool force = false);
+
 	void reset();
 
+	// the rate last written to the valve, or NaN
+	value_t last_update() const;
+
+	// Continues from the value another fan wrote to the same valve.
+	void take_over(const fan &o);
+
+	/*
+	 * The rate a fan is driven with for a control rate, given the fan's
+	 * current speed: a stopped fan needs min_start to start turning, and a
+	 * turning one stops below max_stop.
+	 */
+	static value_t effective_value(value_t rate, double gauge, value_t min_start, value_t max_stop);
+
+	// whether a valve holding the last value is written the new one
+	static bool needs_update(value_t value, value_t last);
+
 	bool operator==(const fan &o) const;
 
 	shared_ptr<const control> m_dependency;
@@ -75,7 +101,10 @@ public:
 
 	class gauge_wrapper: public util::property_wrapper<shared_ptr<SF>, gauge_type_guard> {
 	public:
+		gauge_wrapper();
 		double read() const;
+		double read_live() const;
+		const double *m_sample;
 		friend class config;
 	}
 	m_gauge;
@@ -83,23 +112,47 @@ public:
 	class valve_wrapper: public util::property_wrapper<shared_ptr<pwm>, valve_type_guard> {
 	public:
 		value_t read();
-		void write(value_t value);
+		// 0 or an errno value
+		int write(value_t value);
 		friend class config;
 	}
 	m_valve;
 
 private:
-	value_t effective_value(value_t) const;
+	value_t effective_value(value_t, bool live_gauge = false) const;
 
-	void update_valve(bool force, value_t);
+	int update_valve(bool force, value_t);
 
 	value_t m_last_update;
+
+	value_t m_pending;
 };
 
 
 
 // implementation =============================================================
 
+inline
+fan::value_t fan::last_update() const
+{
+	return m_last_update;
+}
+
+
+inline
+fan::value_t fan::effective_value(value_t value, double gauge, value_t min_start, value_t max_stop)
+{
+	if (value > 0 && value < min_start) {
+		if (gauge == 0) {
+			value = min_start;
+		} else if (value < max_stop) {
+			value = max_stop;
+		}
+	}
+	return value;
+}
+
+
 inline
 bool fan::gauge_type_guard::check(const shared_ptr<SF> &, const shared_ptr<SF> &gauge)
 {
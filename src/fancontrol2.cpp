@@ -6,39 +6,106 @@
  */
 
 #include "utils.hpp"
-#include "fan.hpp"
-#include <boost/foreach.hpp>
+#include "main_loop.hpp"
+#include "training.hpp"
+#include "replay.hpp"
+#include "metrics_server.hpp"
+#include "status.hpp"
+#include "util/preprocessor.hpp"
+#include <iostream>
 #include <memory>
 #include <cstdlib>
-#include <csignal>
+#include <cstring>
+
+
+// training builds wrap this in their own, see training.cpp
+#if !FANCONTROL_TRAINING
+int main(int argc, char *argv[])
+{
+	return fancontrol::main(argc, argv);
+}
+#endif
 
 
 namespace fancontrol {
 
+/*
+ * Prints the latest state the daemon published, one channel per line.
+ */
+static int show_status(const char *path)
+{
+	const status::reader reader(path);
+	status::reader::state state;
+	if (!reader.read(state)) {
+		std::cerr << path << " holds no complete tick yet" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (reader.pid() != 0) {
+		std::cout << "pid " << reader.pid();
+	} else {
+		std::cout << "stopped";
+	}
+	std::cout << ", tick " << state.ticks << " at ";
+	telemetry::write_time(std::cout, state.time_ns) << '\n';
+
+	const std::vector<telemetry::channel> &channels = reader.channels();
+	for (std::size_t i = 0; i < channels.size(); i++) {
+		std::cout << telemetry::to_string(static_cast<telemetry::channel_kind>(channels[i].kind))
+			<< '\t' << channels[i].name << '\t' << state.values[i] << '\n';
+	}
+	std::cout << std::flush;
+	return reader.pid() != 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
 int main(int argc, char *argv[])
 {
 	int r = EXIT_SUCCESS;
 	std::unique_ptr<fancontrol::config_wrapper> cfg_wrap;
 
 	try {
+		if (argc >= 2 && std::strcmp(argv[1], "status") == 0)
+			return show_status((argc >= 3) ? argv[2] : status::default_path);
+
 		cfg_wrap = fancontrol::config_wrapper::make_config(argc, argv);
-		config::fans_container &fans = cfg_wrap->cfg.fans;
+		config &cfg = cfg_wrap->cfg();
+
+		if (cfg_wrap->replay_trace) {
+			const telemetry::trace trace(cfg_wrap->replay_trace);
+			r = replay(cfg, trace).run(std::cout, std::clog);
 
-		if (!cfg_wrap->do_check) {
-			register_signal_handlers();
+		} else if (!cfg_wrap->do_check) {
+			main_loop loop(cfg, cfg_wrap->interval);
+			std::unique_ptr<metrics_server> metrics;
+			const auto start_metrics = [&cfg_wrap, &loop, &metrics]() {
+				const config &cfg = cfg_wrap->cfg();
+				if (!cfg.metrics_socket.empty())
+					metrics.reset(new metrics_server(cfg, loop.events(), cfg.metrics_socket));
+			};
+			start_metrics();
 
-			r = -SIGCONT; // force update on first run
-			do {
-				BOOST_FOREACH(shared_ptr<fan> &f, fans){
-					const bool force = r == -SIGCONT;
-					f->update_valve(force);
+			loop.on_reload([&cfg_wrap, &metrics, &start_metrics]() -> config& {
+				std::unique_ptr<config> next(cfg_wrap->load());
+				metrics.reset();
+				cfg_wrap->replace(std::move(next));
+				// the loop continues with the new configuration regardless
+				try {
+					start_metrics();
+				} catch (std::exception &e) {
+					std::clog << "Metrics are unavailable: " << e.what() << std::endl;
 				}
-			} while ((r = sleep(&cfg_wrap->interval)) < 0);
+				return cfg_wrap->cfg();
+			});
 
+			r = loop.run();
+			metrics.reset();
+			UTIL_DEBUG(std::clog << "Statistics: " << cfg_wrap->cfg().stats << std::endl);
+			std::clog << cfg_wrap->cfg().timings << std::flush;
 			cfg_wrap.reset();
 
 		} else {
-			r = !fans.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+			r = !cfg.fans.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
 		}
 	} catch (util::exception_base &e) {
 		r = handle_exception(e, !!cfg_wrap);
@@ -50,10 +117,3 @@ int main(int argc, char *argv[])
 }
 
 }
-
-
-int main(int argc, char *argv[])
-{
-	return fancontrol::main(argc, argv);
-}
-
@@ -0,0 +1,172 @@
+/*
+ * main_loop.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "main_loop.hpp"
+#include "config.hpp"
+#include "util/preprocessor.hpp"
+#include "util/assert.hpp"
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <cmath>
+#include <csignal>
+#include <sys/epoll.h>
+
+
+namespace fancontrol {
+
+main_loop::main_loop(config &cfg, const struct timespec &interval, util::clock *clock)
+	: m_cfg(&cfg)
+	, m_interval(interval)
+	, m_last_tick()
+	, m_ticked(false)
+	, m_real_clock(CLOCK_MONOTONIC)
+	, m_clock(clock ? *clock : m_real_clock)
+	, m_timer(m_real_clock.id())
+	, m_signals({ SIGHUP, SIGINT, SIGQUIT, SIGPIPE, SIGTERM, SIGCONT, SIGUSR1 })
+{
+	m_loop.add(m_timer.fd(), EPOLLIN, [this](std::uint32_t events) { on_timer(events); });
+	m_loop.add(m_signals.fd(), EPOLLIN, [this](std::uint32_t events) { on_signal(events); });
+}
+
+
+int main_loop::run()
+{
+	tick(true); // force update on first run
+	m_timer.arm(m_interval);
+	return m_loop.run();
+}
+
+
+unsigned long main_loop::run_until(const struct timespec &end, const tick_hook &before_tick)
+{
+	unsigned long ticks = 0;
+	struct timespec deadline = m_clock.now();
+	while (!m_loop.stopped() && util::timespec_less(deadline, end)) {
+		m_clock.sleep_until(deadline);
+		if (before_tick)
+			before_tick(deadline);
+		tick(ticks == 0);
+		ticks++;
+		util::timespec_add(deadline, m_interval);
+	}
+	return ticks;
+}
+
+
+/*
+ * Returns whether the interval changed, so the caller re-arms the timer.
+ *
+ * The deviation of the time between two ticks from the interval is recorded
+ * as jitter, unless the tick was forced out of order.
+ */
+bool main_loop::tick(bool force)
+{
+	const struct timespec now = m_clock.now();
+	const double elapsed = m_ticked ? util::to_seconds(now) - util::to_seconds(m_last_tick) : 0;
+	if (m_ticked && !force)
+		m_cfg->timings.jitter.record(static_cast<std::uint64_t>(std::abs(elapsed - interval()) * 1e9));
+	m_last_tick = now;
+	m_ticked = true;
+
+	m_cfg->update(force);
+	return m_cfg->adaptive.enabled() && adapt(elapsed);
+}
+
+
+double main_loop::interval() const
+{
+	return util::to_seconds(m_interval);
+}
+
+
+bool main_loop::adapt(double elapsed)
+{
+	const double last = m_cfg->adaptive.current();
+	const double next = m_cfg->adaptive.update(m_cfg->plan, m_cfg->samples.values(), elapsed);
+	if (next == last)
+		return false;
+
+	UTIL_DEBUG(std::cerr << "Polling interval: " << next << 's' << std::endl);
+	m_interval = util::to_timespec(next);
+	return true;
+}
+
+
+void main_loop::on_reload(const reload_hook &hook)
+{
+	m_reload = hook;
+}
+
+
+/*
+ * The fans carry on from their last values, so the tick right after the
+ * reload is not forced, and the interval restarts from there.
+ */
+void main_loop::reload()
+{
+	try {
+		m_cfg = &m_reload();
+	} catch (std::exception &e) {
+		std::clog << "Keeping the current configuration: " << e.what() << std::endl;
+		return;
+	}
+
+	m_interval = util::to_timespec(m_cfg->interval());
+	m_ticked = false;  // no jitter across configurations
+	tick();
+	m_timer.arm(m_interval);
+}
+
+
+void main_loop::on_timer(std::uint32_t)
+{
+	// Missed expirations are coalesced into a single tick.
+	if (m_timer.expirations() != 0 && tick())
+		m_timer.arm(m_interval);
+}
+
+
+void main_loop::on_signal(std::uint32_t)
+{
+	int signal;
+	while (!m_loop.stopped() && m_signals.read(signal)) {
+		switch (signal) {
+			case SIGHUP:
+				if (m_reload) {
+					reload();
+					break;
+				}
+				// fall through
+			case SIGINT:
+			case SIGQUIT:
+			case SIGTERM:
+				// no error, but request reset and leave
+				m_loop.stop(EXIT_SUCCESS);
+				break;
+
+			case SIGUSR1:
+				std::clog << m_cfg->timings << std::flush;
+				break;
+
+			case SIGCONT:
+				// request to poll now and restart the interval from here
+				tick(true);
+				m_timer.arm(m_interval);
+				break;
+
+			default:  // e.g. SIGPIPE
+				UTIL_DEBUG(std::cerr
+					<< "Interrupted by signal " << signal << std::endl);
+				// reset and leave with non-zero return value
+				m_loop.stop(2);
+				break;
+		}
+	}
+}
+
+} /* namespace fancontrol */
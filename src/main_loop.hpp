@@ -0,0 +1,117 @@
+/*
+ * main_loop.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef FANCONTROL_MAIN_LOOP_HPP_
+#define FANCONTROL_MAIN_LOOP_HPP_
+
+#include "util/event_loop.hpp"
+#include "util/clock.hpp"
+#include <functional>
+#include <cstdint>
+#include <ctime>
+
+
+namespace fancontrol {
+
+class config;
+
+
+/*
+ * Drives the ticks of a configuration from an absolute-deadline timer and
+ * receives control signals synchronously through a signal descriptor. Both
+ * share one event loop, which other event sources may join.
+ *
+ * If the configuration enables an adaptive interval, the timer period is
+ * recomputed after every tick. SIGUSR1 prints the tick latencies. SIGHUP
+ * replaces the configuration through the reload hook if there is one and
+ * stops the loop otherwise.
+ *
+ * All time measurements go through a clock, which defaults to the monotonic
+ * system clock. With a virtual clock, run_until() simulates the ticks of any
+ * span of time without waiting.
+ */
+class main_loop
+{
+public:
+	typedef std::function<void(const struct timespec &now)> tick_hook;
+
+	/*
+	 * Returns the configuration to continue with. It may throw to keep the
+	 * current one, but only before it discards that.
+	 */
+	typedef std::function<config&()> reload_hook;
+
+	main_loop(config &cfg, const struct timespec &interval, util::clock *clock = nullptr);
+
+	int run();
+
+	/*
+	 * Runs ticks at their deadlines until the clock reaches the end, sleeping
+	 * on the clock in between instead of waiting for events. Calls the hook
+	 * before every tick, e. g. to update a simulated environment. Returns the
+	 * number of ticks.
+	 */
+	unsigned long run_until(const struct timespec &end, const tick_hook &before_tick = tick_hook());
+
+	util::event_loop &events();
+
+	bool tick(bool force = false);
+
+	void on_reload(const reload_hook &hook);
+
+	// the current timer period in seconds
+	double interval() const;
+
+	util::clock &clock();
+
+private:
+	bool adapt(double elapsed);
+
+	void reload();
+
+	void on_timer(std::uint32_t events);
+
+	void on_signal(std::uint32_t events);
+
+	config *m_cfg;
+
+	reload_hook m_reload;
+
+	struct timespec m_interval, m_last_tick;
+
+	bool m_ticked;
+
+	util::real_clock m_real_clock;
+
+	util::clock &m_clock;
+
+	util::event_loop m_loop;
+
+	util::timer_source m_timer;
+
+	util::signal_source m_signals;
+};
+
+
+
+// implementations ========================================
+
+inline
+util::event_loop &main_loop::events()
+{
+	return m_loop;
+}
+
+
+inline
+util::clock &main_loop::clock()
+{
+	return m_clock;
+}
+
+} /* namespace fancontrol */
+#endif /* FANCONTROL_MAIN_LOOP_HPP_ */
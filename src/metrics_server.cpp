@@ -0,0 +1,323 @@
+/*
+ * metrics_server.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "metrics_server.hpp"
+#include "config.hpp"
+#include "fan.hpp"
+#include "sensors++/pwm.hpp"
+
+#include <sstream>
+#include <ostream>
+#include <cerrno>
+#include <cmath>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+
+namespace fancontrol {
+
+namespace {
+
+	std::string escape_label(const std::string &s)
+	{
+		std::string r;
+		r.reserve(s.size());
+		for (const char c : s) {
+			switch (c) {
+				case '\\': r += "\\\\"; break;
+				case '"': r += "\\\""; break;
+				case '\n': r += "\\n"; break;
+				default: r += c; break;
+			}
+		}
+		return r;
+	}
+
+
+	std::ostream &value(std::ostream &out, double v)
+	{
+		if (std::isnan(v))
+			return out << "NaN";
+		if (std::isinf(v))
+			return out << (v > 0 ? "+Inf" : "-Inf");
+		return out << v;
+	}
+
+
+	void header(std::ostream &out, const char *name, const char *type, const char *help)
+	{
+		out << "# HELP " << name << ' ' << help << "\n"
+			"# TYPE " << name << ' ' << type << '\n';
+	}
+
+
+	void summary(std::ostream &out, const char *name, const char *label,
+		const std::string &label_value, const util::histogram &h)
+	{
+		static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+		for (const double q : quantiles) {
+			out << name << '{' << label << "=\"" << label_value << "\",quantile=\"" << q << "\"} ";
+			value(out, static_cast<double>(h.percentile(q * 100)) * 1e-9) << '\n';
+		}
+		out << name << "_sum{" << label << "=\"" << label_value << "\"} ";
+		value(out, static_cast<double>(h.sum()) * 1e-9) << '\n';
+		out << name << "_count{" << label << "=\"" << label_value << "\"} " << h.count() << '\n';
+	}
+
+
+	bool request_complete(const std::string &request)
+	{
+		if (request.compare(0, 4, "GET ") != 0)
+			return request.size() >= 4;
+		return request.find("\r\n\r\n") != std::string::npos ||
+			request.find("\n\n") != std::string::npos;
+	}
+
+}
+
+
+const std::size_t metrics_server::max_clients, metrics_server::max_request;
+
+const unsigned metrics_server::client_timeout;
+
+
+metrics_server::metrics_server(const config &cfg, util::event_loop &loop, const std::string &path)
+	: m_cfg(cfg)
+	, m_loop(loop)
+	, m_socket(path)
+	, m_accept_paused(false)
+{
+	for (snapshot::size_type i = 0; i < cfg.samples.size(); i++)
+		m_sample_labels.push_back(escape_label(cfg.samples.name(i)));
+	for (const std::string &name : cfg.rate_names())
+		m_rate_labels.push_back(escape_label(name));
+	for (const config::fan_type &f : cfg.fans)
+		m_fan_labels.push_back(escape_label(*f->m_label));
+	for (const std::string &name : cfg.timings.chip_names)
+		m_chip_labels.push_back(escape_label(name));
+
+	m_loop.add(m_socket.fd(), EPOLLIN, [this](std::uint32_t events) { on_accept(events); });
+	m_loop.add(m_timer.fd(), EPOLLIN, [this](std::uint32_t events) { on_timer(events); });
+}
+
+
+metrics_server::~metrics_server()
+{
+	while (!m_clients.empty())
+		close(m_clients.begin()->first);
+	m_loop.remove(m_timer.fd());
+	m_loop.remove(m_socket.fd());
+}
+
+
+void metrics_server::write(std::ostream &out) const
+{
+	const std::streamsize precision = out.precision(9);
+	const config &cfg = m_cfg;
+
+	header(out, "fancontrol2_ticks_total", "counter", "Ticks since the start");
+	out << "fancontrol2_ticks_total " << cfg.stats.ticks << '\n';
+
+	header(out, "fancontrol2_sensor_read_errors_total", "counter", "Failed sensor readings");
+	out << "fancontrol2_sensor_read_errors_total " << cfg.stats.read_errors << '\n';
+
+	header(out, "fancontrol2_pwm_write_errors_total", "counter", "Failed PWM writes");
+	out << "fancontrol2_pwm_write_errors_total " << cfg.stats.write_errors << '\n';
+
+	header(out, "fancontrol2_fallbacks_total", "counter",
+		"Fan updates at the reset rate, because a sensor was never read");
+	out << "fancontrol2_fallbacks_total " << cfg.stats.fallbacks << '\n';
+
+	if (cfg.stats.ticks != 0) {
+		header(out, "fancontrol2_sensor_value", "gauge", "Latest reading of a sensor");
+		const snapshot::value_t *const samples = cfg.samples.values();
+		for (std::size_t i = 0; i < m_sample_labels.size(); i++) {
+			out << "fancontrol2_sensor_value{sensor=\"" << m_sample_labels[i] << "\"} ";
+			value(out, samples[i]) << '\n';
+		}
+
+		header(out, "fancontrol2_control_rate", "gauge", "Latest rate of a control between 0 and 1");
+		const control_plan::value_t *const rates = cfg.plan.rates();
+		for (std::size_t i = 0; i < m_rate_labels.size(); i++) {
+			out << "fancontrol2_control_rate{control=\"" << m_rate_labels[i] << "\"} ";
+			value(out, rates[i]) << '\n';
+		}
+
+		header(out, "fancontrol2_fan_rpm", "gauge", "Latest speed of a fan");
+		for (std::size_t i = 0; i < m_fan_labels.size(); i++) {
+			out << "fancontrol2_fan_rpm{fan=\"" << m_fan_labels[i] << "\"} ";
+			value(out, cfg.fans[i]->m_gauge.read()) << '\n';
+		}
+
+		header(out, "fancontrol2_fan_pwm", "gauge", "Raw value last written to the PWM of a fan");
+		for (std::size_t i = 0; i < m_fan_labels.size(); i++) {
+			out << "fancontrol2_fan_pwm{fan=\"" << m_fan_labels[i] << "\"} ";
+			value(out, cfg.fans[i]->last_update() * static_cast<double>(sensors::pwm::pwm_max())) << '\n';
+		}
+	}
+
+	const tick_timings &t = cfg.timings;
+	header(out, "fancontrol2_tick_phase_seconds", "summary", "Duration of a tick and its phases, and the tick jitter");
+	summary(out, "fancontrol2_tick_phase_seconds", "phase", "tick", t.tick);
+	summary(out, "fancontrol2_tick_phase_seconds", "phase", "sample", t.sample);
+	summary(out, "fancontrol2_tick_phase_seconds", "phase", "evaluate", t.evaluate);
+	summary(out, "fancontrol2_tick_phase_seconds", "phase", "commit", t.commit);
+	summary(out, "fancontrol2_tick_phase_seconds", "phase", "jitter", t.jitter);
+
+	header(out, "fancontrol2_chip_read_seconds", "summary", "Duration of reading the sensors of a chip in a tick");
+	for (std::size_t i = 0; i < m_chip_labels.size(); i++)
+		summary(out, "fancontrol2_chip_read_seconds", "chip", m_chip_labels[i], t.chips[i]);
+
+	header(out, "fancontrol2_fan_write_seconds", "summary", "Duration of writing the PWM of a fan");
+	for (std::size_t i = 0; i < m_fan_labels.size(); i++)
+		summary(out, "fancontrol2_fan_write_seconds", "fan", m_fan_labels[i], t.fans[i]);
+
+	out.precision(precision);
+}
+
+
+/*
+ * When the process or the system runs out of descriptors or memory, the
+ * pending connection stays in the backlog and the listening socket stays
+ * readable. Accepting then pauses until a client closes or the timer expires,
+ * instead of spinning on the socket.
+ */
+void metrics_server::on_accept(std::uint32_t)
+{
+	if (m_clients.empty() && !m_accept_paused)
+		m_timer.arm(util::to_timespec(1));
+
+	int fd;
+	while ((fd = m_socket.accept()) >= 0) {
+		if (m_clients.size() >= max_clients) {
+			::close(fd);
+			continue;
+		}
+		client &c = m_clients[fd];
+		c.sent = 0;
+		c.deadline = util::monotonic_ns() + client_timeout * UINT64_C(1000000000);
+		m_loop.add(fd, EPOLLIN, [this, fd](std::uint32_t events) { on_client(fd, events); });
+	}
+
+	switch (errno) {
+		case EMFILE:
+		case ENFILE:
+		case ENOBUFS:
+		case ENOMEM:
+			pause_accept(true);
+			break;
+	}
+	if (m_clients.empty() && !m_accept_paused)
+		m_timer.disarm();
+}
+
+
+void metrics_server::on_timer(std::uint32_t)
+{
+	m_timer.expirations();
+	const std::uint64_t now = util::monotonic_ns();
+	for (std::unordered_map<int, client>::iterator it = m_clients.begin(); it != m_clients.end(); ) {
+		const int fd = it->first;
+		const bool expired = it->second.deadline <= now;
+		++it;
+		if (expired)
+			close(fd);
+	}
+
+	pause_accept(false);
+	if (m_clients.empty())
+		m_timer.disarm();
+}
+
+
+void metrics_server::pause_accept(bool pause)
+{
+	if (pause != m_accept_paused) {
+		m_loop.modify(m_socket.fd(), pause ? 0 : static_cast<std::uint32_t>(EPOLLIN));
+		m_accept_paused = pause;
+	}
+}
+
+
+/*
+ * The request is read until it is complete or the client shuts down its
+ * end, then the response is sent as far as the socket takes it and the
+ * rest when it becomes writable again.
+ */
+void metrics_server::on_client(int fd, std::uint32_t events)
+{
+	const std::unordered_map<int, client>::iterator it = m_clients.find(fd);
+	if (it == m_clients.end())
+		return;
+	client &c = it->second;
+	if (events & EPOLLERR) {
+		close(fd);
+		return;
+	}
+
+	if (c.response.empty()) {
+		char buffer[1024];
+		ssize_t n = 0;
+		while (c.request.size() < max_request &&
+			(n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0)
+		{
+			c.request.append(buffer, static_cast<std::size_t>(n));
+		}
+		const bool eof = c.request.size() < max_request && n == 0;
+		if (!eof && c.request.size() < max_request && n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+			close(fd);
+			return;
+		}
+		if (!eof && c.request.size() < max_request && !request_complete(c.request))
+			return;
+
+		respond(fd, c);
+	}
+
+	while (c.sent < c.response.size()) {
+		const ssize_t n = ::send(fd, c.response.data() + c.sent, c.response.size() - c.sent, MSG_NOSIGNAL);
+		if (n < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				close(fd);
+			return;
+		}
+		c.sent += static_cast<std::size_t>(n);
+	}
+	close(fd);
+}
+
+
+void metrics_server::respond(int fd, client &c)
+{
+	std::ostringstream body;
+	write(body);
+
+	if (c.request.compare(0, 4, "GET ") == 0) {
+		std::ostringstream response;
+		response << "HTTP/1.0 200 OK\r\n"
+			"Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+			"Content-Length: " << body.tellp() << "\r\n"
+			"Connection: close\r\n"
+			"\r\n" << body.str();
+		c.response = response.str();
+	} else {
+		c.response = body.str();
+	}
+	c.request.clear();
+	m_loop.modify(fd, EPOLLOUT);
+}
+
+
+void metrics_server::close(int fd)
+{
+	m_loop.remove(fd);
+	m_clients.erase(fd);
+	::close(fd);
+	pause_accept(false);
+}
+
+} /* namespace fancontrol */
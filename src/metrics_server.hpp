@@ -0,0 +1,93 @@
+/*
+ * metrics_server.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef FANCONTROL_METRICS_SERVER_HPP_
+#define FANCONTROL_METRICS_SERVER_HPP_
+
+#include "util/event_loop.hpp"
+
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <iosfwd>
+#include <cstdint>
+
+
+namespace fancontrol {
+
+class config;
+
+
+/*
+ * Serves the latest readings, rates, fan speeds and PWM values and the tick
+ * latencies in the Prometheus text exposition format on a Unix socket, so
+ * monitoring needn't read the sensors a second time. A request starting
+ * with "GET " is answered as HTTP/1.0, anything else, including an empty
+ * request, with the bare text.
+ *
+ * Connections are handled non-blocking in the main loop's event loop
+ * between ticks. The text is rendered from the configuration's state when
+ * a request arrives, so ticks publish nothing. A client that hasn't been
+ * served within the timeout is disconnected, so idle clients can't hold on
+ * to the connection slots.
+ */
+class metrics_server
+{
+public:
+	metrics_server(const config &cfg, util::event_loop &loop, const std::string &path);
+
+	~metrics_server();
+
+	void write(std::ostream &out) const;
+
+	static const std::size_t max_clients = 8, max_request = 4096;
+
+	// seconds
+	static const unsigned client_timeout = 5;
+
+private:
+	struct client
+	{
+		std::string request, response;
+
+		std::size_t sent;
+
+		// util::monotonic_ns()
+		std::uint64_t deadline;
+	};
+
+	void on_accept(std::uint32_t events);
+
+	void on_timer(std::uint32_t events);
+
+	void pause_accept(bool pause);
+
+	void on_client(int fd, std::uint32_t events);
+
+	void respond(int fd, client &c);
+
+	void close(int fd);
+
+	const config &m_cfg;
+
+	util::event_loop &m_loop;
+
+	util::listen_socket m_socket;
+
+	// checks the deadlines while there are clients or accepting is paused
+	util::timer_source m_timer;
+
+	bool m_accept_paused;
+
+	// label values, escaped
+	std::vector<std::string> m_sample_labels, m_rate_labels, m_fan_labels, m_chip_labels;
+
+	std::unordered_map<int, client> m_clients;
+};
+
+} /* namespace fancontrol */
+#endif /* FANCONTROL_METRICS_SERVER_HPP_ */
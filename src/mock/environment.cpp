@@ -0,0 +1,39 @@
+/*
+ * environment.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "environment.hpp"
+#include <cstdlib>
+
+
+namespace fancontrol {
+	namespace mock {
+
+const std::string &hwmon_root()
+{
+	static const std::string root = []() -> std::string {
+		const char *const env = std::getenv(FANCONTROL_MOCK_HWMON_ENV);
+		std::string s((env && *env) ? env : "/sys/class/hwmon");
+		while (s.size() > 1 && s.back() == '/')
+			s.pop_back();
+		return s;
+	}();
+	return root;
+}
+
+
+unsigned long latency_from_env(const char *name)
+{
+	const char *const env = std::getenv(name);
+	if (!env || !*env)
+		return 0;
+
+	char *end;
+	const unsigned long us = std::strtoul(env, &end, 10);
+	return (*end == '\0') ? us : 0;
+}
+
+	} /* namespace mock */
+} /* namespace fancontrol */
@@ -0,0 +1,36 @@
+/*
+ * environment.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef FANCONTROL_MOCK_ENVIRONMENT_HPP_
+#define FANCONTROL_MOCK_ENVIRONMENT_HPP_
+
+#include <string>
+
+
+#define FANCONTROL_MOCK_HWMON_ENV "FANCONTROL_MOCK_HWMON"
+#define FANCONTROL_MOCK_READ_LATENCY_ENV "FANCONTROL_MOCK_READ_LATENCY_US"
+#define FANCONTROL_MOCK_WRITE_LATENCY_ENV "FANCONTROL_MOCK_WRITE_LATENCY_US"
+
+// contained in libsensors_version of the stand-in
+#define FANCONTROL_MOCK_VERSION_TAG "fancontrol2 mock"
+
+
+namespace fancontrol {
+	namespace mock {
+
+/*
+ * The directory that takes the place of /sys/class/hwmon, taken from the
+ * environment variable FANCONTROL_MOCK_HWMON, without trailing slashes.
+ */
+const std::string &hwmon_root();
+
+// per-access latency in microseconds from the environment, or 0
+unsigned long latency_from_env(const char *name);
+
+	} /* namespace mock */
+} /* namespace fancontrol */
+#endif /* FANCONTROL_MOCK_ENVIRONMENT_HPP_ */
@@ -0,0 +1,248 @@
+/*
+ * hwmon.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "hwmon.hpp"
+#include "util/exception.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/exception/all.hpp>
+#include <fstream>
+#include <sstream>
+#include <ostream>
+#include <algorithm>
+#include <cstdlib>
+#include <cerrno>
+
+
+namespace fancontrol {
+	namespace mock {
+
+using util::io_error;
+namespace fs = boost::filesystem;
+
+
+namespace {
+
+	void throw_io_error(const char *what, const std::string &path, int errnum = errno)
+	{
+		BOOST_THROW_EXCEPTION(io_error()
+			<< io_error::what_t(what)
+			<< io_error::filename(path)
+			<< io_error::errno_code(errnum));
+	}
+
+}
+
+
+hwmon_tree::chip_spec::chip_spec(unsigned temps, unsigned fans, unsigned pwms)
+	: temps(temps), fans(fans), pwms(pwms)
+	, virtual_bus(false)
+{
+}
+
+
+hwmon_tree::config_options::config_options()
+	: interval(1)
+	, dependencies(2)
+	, keep_open(true)
+	, direct_read(true)
+	, adaptive(false)
+	, sampler("sync")
+{
+}
+
+
+hwmon_tree::hwmon_tree()
+	: m_root(make_temp_root())
+	, m_owned(true)
+{
+}
+
+
+hwmon_tree::hwmon_tree(const std::string &root)
+	: m_root(root)
+	, m_owned(false)
+{
+	boost::system::error_code ec;
+	fs::create_directories(m_root, ec);
+	if (ec)
+		throw_io_error("Couldn't create the mock hwmon directory", m_root, ec.value());
+}
+
+
+std::string hwmon_tree::make_temp_root(const char *parent)
+{
+	const char *const tmpdir = (parent && *parent) ? parent : std::getenv("TMPDIR");
+	std::string path((tmpdir && *tmpdir) ? tmpdir : "/tmp");
+	path += "/fancontrol2-hwmon.XXXXXX";
+	if (!::mkdtemp(&path[0]))
+		throw_io_error("Couldn't create the mock hwmon directory", path);
+	return path;
+}
+
+
+hwmon_tree::~hwmon_tree()
+{
+	if (m_owned) {
+		boost::system::error_code ec;
+		fs::remove_all(m_root, ec);
+	}
+}
+
+
+const std::string &hwmon_tree::root() const
+{
+	return m_root;
+}
+
+
+bool hwmon_tree::owned() const
+{
+	return m_owned;
+}
+
+
+void hwmon_tree::keep(bool keep)
+{
+	m_owned = !keep;
+}
+
+
+unsigned hwmon_tree::add_chip(const chip_spec &spec)
+{
+	const unsigned index = chip_count();
+	const std::string dir(attribute_path(index, std::string()));
+	boost::system::error_code ec;
+	fs::create_directory(dir, ec);
+	if (ec)
+		throw_io_error("Couldn't create the mock chip directory", dir, ec.value());
+	m_chips.push_back(spec);
+
+	std::ofstream name(attribute_path(index, "name").c_str());
+	name << chip_name(index) << '\n';
+	if (!name.flush())
+		throw_io_error("Couldn't write the mock chip name", attribute_path(index, "name"));
+
+	if (spec.virtual_bus) {
+		std::ofstream marker(attribute_path(index, "mock_virtual").c_str());
+		if (!marker.flush())
+			throw_io_error("Couldn't write the mock chip's bus", attribute_path(index, "mock_virtual"));
+	}
+
+	std::ostringstream attr;
+	for (unsigned i = 1; i <= spec.temps; i++) {
+		attr.str(std::string()); attr << "temp" << i << "_input";
+		write(index, attr.str(), 35000 + 500 * static_cast<long>(i % 10));
+	}
+	for (unsigned i = 1; i <= spec.fans; i++) {
+		attr.str(std::string()); attr << "fan" << i << "_input";
+		write(index, attr.str(), 1200);
+	}
+	for (unsigned i = 1; i <= spec.pwms; i++) {
+		attr.str(std::string()); attr << "pwm" << i;
+		write(index, attr.str(), 128);
+		attr << "_enable";
+		write(index, attr.str(), 1);
+	}
+	return index;
+}
+
+
+unsigned hwmon_tree::chip_count() const
+{
+	return static_cast<unsigned>(m_chips.size());
+}
+
+
+const hwmon_tree::chip_spec &hwmon_tree::chip(unsigned index) const
+{
+	return m_chips.at(index);
+}
+
+
+std::string hwmon_tree::chip_name(unsigned index) const
+{
+	std::ostringstream s;
+	s << "mock" << index;
+	return s.str();
+}
+
+
+std::string hwmon_tree::attribute_path(unsigned chip, const std::string &attribute) const
+{
+	std::ostringstream s;
+	s << m_root << "/hwmon" << chip;
+	if (!attribute.empty())
+		s << '/' << attribute;
+	return s.str();
+}
+
+
+long hwmon_tree::read(unsigned chip, const std::string &attribute) const
+{
+	const std::string path(attribute_path(chip, attribute));
+	std::ifstream in(path.c_str());
+	long value;
+	if (!(in >> value))
+		throw_io_error("Couldn't read the mock attribute", path);
+	return value;
+}
+
+
+void hwmon_tree::write(unsigned chip, const std::string &attribute, long value) const
+{
+	const std::string path(attribute_path(chip, attribute));
+	std::ofstream out(path.c_str(), std::ios::out | std::ios::trunc);
+	out << value << '\n';
+	if (!out.flush())
+		throw_io_error("Couldn't write the mock attribute", path);
+}
+
+
+void hwmon_tree::write_config(std::ostream &out, const config_options &options) const
+{
+	out << std::boolalpha << "---\n"
+		"interval: " << options.interval << "\n"
+		"keep_open: " << options.keep_open << "\n"
+		"direct_read: " << options.direct_read << "\n"
+		"sampler: " << options.sampler << "\n";
+	if (options.adaptive)
+		out << "adaptive: {min: 1, max: 20, threshold: 0.02}\n";
+	if (!options.telemetry.empty())
+		out << "telemetry: {path: " << options.telemetry << ", records: 4096}\n";
+	if (!options.status_segment.empty())
+		out << "status_segment: " << options.status_segment << "\n";
+	out << "\n"
+		"fans:\n";
+
+	for (unsigned c = 0; c < chip_count(); c++) {
+		const chip_spec &spec = m_chips[c];
+		const std::string name(chip_name(c));
+		const unsigned fans = std::min(spec.fans, spec.pwms);
+
+		for (unsigned f = 1; f <= fans; f++) {
+			out << "    " << name << "_fan" << f << ":\n"
+				"        gauge: {chip: {name: " << name << "}, input: fan" << f << "_input}\n"
+				"        valve: {chip: {name: " << name << "}, output: " << f << "}\n"
+				"        start: 0.35\n"
+				"        stop: 0.31\n"
+				"        reset: 0.75\n"
+				"        dependencies:";
+
+			const unsigned n = std::min(options.dependencies, spec.temps);
+			if (n == 0)
+				out << " []";
+			out << '\n';
+			for (unsigned d = 0; d < n; d++) {
+				out << "            - {source: {chip: {name: " << name << "}, input: temp"
+					<< (((f - 1) * n + d) % spec.temps + 1) << "_input}, min: 30, max: 60}\n";
+			}
+		}
+	}
+}
+
+	} /* namespace mock */
+} /* namespace fancontrol */
@@ -0,0 +1,116 @@
+/*
+ * hwmon.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef FANCONTROL_MOCK_HWMON_HPP_
+#define FANCONTROL_MOCK_HWMON_HPP_
+
+#include <vector>
+#include <string>
+#include <iosfwd>
+
+
+namespace fancontrol {
+	namespace mock {
+
+/*
+ * A directory tree in the layout of /sys/class/hwmon with regular files as
+ * attributes, to be served by the libsensors stand-in (libsensors.cpp) when
+ * FANCONTROL_MOCK_HWMON points to its root.
+ *
+ * Chip N lives in "hwmon<N>" and is named "mock<N>". Its temperature inputs
+ * start at 35 °C, its fan inputs at 1200 RPM and its PWM outputs at 128 in
+ * manual mode. A virtual chip has an empty "mock_virtual" attribute and, like
+ * every ACPI or virtual chip of a real system, sits at bus number and address 0.
+ */
+class hwmon_tree
+{
+public:
+	struct chip_spec
+	{
+		chip_spec(unsigned temps = 2, unsigned fans = 1, unsigned pwms = 1);
+
+		unsigned temps, fans, pwms;
+
+		bool virtual_bus;
+	};
+
+	struct config_options
+	{
+		config_options();
+
+		double interval;
+
+		// temperature inputs per fan
+		unsigned dependencies;
+
+		bool keep_open, direct_read;
+
+		// an adaptive interval like the one the example configuration suggests
+		bool adaptive;
+
+		// "sync" or "io_uring"
+		std::string sampler;
+
+		// left out if empty
+		std::string telemetry, status_segment;
+	};
+
+	// Creates a new temporary root that is removed on destruction.
+	hwmon_tree();
+
+	// Uses (and creates) the given root, which is left in place.
+	explicit hwmon_tree(const std::string &root);
+
+	~hwmon_tree();
+
+	// Creates a new empty directory below parent, or else $TMPDIR or /tmp.
+	static std::string make_temp_root(const char *parent = nullptr);
+
+	const std::string &root() const;
+
+	bool owned() const;
+
+	void keep(bool keep = true);
+
+	// Returns the index of the new chip.
+	unsigned add_chip(const chip_spec &spec);
+
+	unsigned chip_count() const;
+
+	const chip_spec &chip(unsigned index) const;
+
+	std::string chip_name(unsigned index) const;
+
+	std::string attribute_path(unsigned chip, const std::string &attribute) const;
+
+	long read(unsigned chip, const std::string &attribute) const;
+
+	void write(unsigned chip, const std::string &attribute, long value) const;
+
+	/*
+	 * Writes a fancontrol2 configuration with one fan per PWM output of
+	 * every chip. A fan depends on up to the configured number of
+	 * temperature inputs of its chip; consecutive fans take consecutive
+	 * blocks of inputs, wrapping around after the last.
+	 */
+	void write_config(std::ostream &out, const config_options &options = config_options()) const;
+
+private:
+	hwmon_tree(const hwmon_tree&) = delete;
+
+	hwmon_tree &operator=(const hwmon_tree&) = delete;
+
+	std::string m_root;
+
+	bool m_owned;
+
+	std::vector<chip_spec> m_chips;
+};
+
+	} /* namespace mock */
+} /* namespace fancontrol */
+#endif /* FANCONTROL_MOCK_HWMON_HPP_ */
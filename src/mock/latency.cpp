@@ -0,0 +1,280 @@
+/*
+ * latency.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+/*
+ * Interposes the file system calls used to access hwmon attributes, so that
+ * every read and write of a file below the mock root (see hwmon_root()) takes
+ * at least the latency given in microseconds by the environment variables
+ * FANCONTROL_MOCK_READ_LATENCY_US and FANCONTROL_MOCK_WRITE_LATENCY_US. Real
+ * sysfs attributes of slow chips (e. g. on SMBus) may take milliseconds.
+ *
+ * This only works for calls that go through the dynamic symbol table; requests
+ * submitted through io_uring bypass it and see no added latency. Buffered
+ * stdio reads and writes are delayed once per underlying system call.
+ */
+
+#ifndef _GNU_SOURCE
+#	define _GNU_SOURCE 1
+#endif
+// the fortified inline wrappers would clash with the definitions below
+#undef _FORTIFY_SOURCE
+
+#include "environment.hpp"
+
+#include <vector>
+#include <cstring>
+#include <cstdarg>
+#include <ctime>
+#include <cerrno>
+#include <cstdio>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+namespace {
+
+using fancontrol::mock::hwmon_root;
+using fancontrol::mock::latency_from_env;
+
+
+template <typename F>
+F next(const char *name)
+{
+	return reinterpret_cast<F>(::dlsym(RTLD_NEXT, name));
+}
+
+
+struct latencies
+{
+	unsigned long read_us, write_us;
+
+	latencies()
+		: read_us(latency_from_env(FANCONTROL_MOCK_READ_LATENCY_ENV))
+		, write_us(latency_from_env(FANCONTROL_MOCK_WRITE_LATENCY_ENV))
+	{
+	}
+
+	bool enabled() const
+	{
+		return read_us || write_us;
+	}
+};
+
+const latencies &latency()
+{
+	static const latencies l;
+	return l;
+}
+
+
+// file descriptors that refer to files below the mock root
+std::vector<bool> &mocked_fds()
+{
+	static std::vector<bool> fds;
+	return fds;
+}
+
+
+bool below_root(int dirfd, const char *path)
+{
+	if (!path)
+		return false;
+	if (path[0] != '/')
+		return dirfd >= 0 && static_cast<std::size_t>(dirfd) < mocked_fds().size() && mocked_fds()[dirfd];
+
+	const std::string &root = hwmon_root();
+	return std::strncmp(path, root.c_str(), root.size()) == 0 &&
+		(path[root.size()] == '/' || path[root.size()] == '\0');
+}
+
+
+int track(int fd, bool mocked)
+{
+	if (fd >= 0) {
+		std::vector<bool> &fds = mocked_fds();
+		if (static_cast<std::size_t>(fd) >= fds.size()) {
+			if (!mocked)
+				return fd;
+			fds.resize(static_cast<std::size_t>(fd) + 1);
+		}
+		fds[fd] = mocked;
+	}
+	return fd;
+}
+
+
+void delay(int fd, unsigned long us)
+{
+	if (us && fd >= 0 && static_cast<std::size_t>(fd) < mocked_fds().size() && mocked_fds()[fd]) {
+		const int saved_errno = errno;
+		timespec ts;
+		ts.tv_sec = static_cast<time_t>(us / 1000000);
+		ts.tv_nsec = static_cast<long>(us % 1000000) * 1000;
+		while (::nanosleep(&ts, &ts) != 0 && errno == EINTR)
+			;
+		errno = saved_errno;
+	}
+}
+
+
+int opened(int fd, int dirfd, const char *path)
+{
+	return latency().enabled() ? track(fd, below_root(dirfd, path)) : fd;
+}
+
+
+mode_t mode_arg(int flags, va_list ap)
+{
+#ifdef O_TMPFILE
+	const bool has_mode = (flags & O_CREAT) || (flags & O_TMPFILE) == O_TMPFILE;
+#else
+	const bool has_mode = (flags & O_CREAT);
+#endif
+	return has_mode ? static_cast<mode_t>(va_arg(ap, int)) : 0;
+}
+
+}
+
+
+extern "C" {
+
+int open(const char *path, int flags, ...)
+{
+	typedef int (*fn_type)(const char*, int, ...);
+	static const fn_type fn = next<fn_type>("open");
+	va_list ap;
+	va_start(ap, flags);
+	const mode_t mode = mode_arg(flags, ap);
+	va_end(ap);
+	return opened(fn(path, flags, mode), AT_FDCWD, path);
+}
+
+
+int open64(const char *path, int flags, ...)
+{
+	typedef int (*fn_type)(const char*, int, ...);
+	static const fn_type fn = next<fn_type>("open64");
+	va_list ap;
+	va_start(ap, flags);
+	const mode_t mode = mode_arg(flags, ap);
+	va_end(ap);
+	return opened(fn(path, flags, mode), AT_FDCWD, path);
+}
+
+
+int openat(int dirfd, const char *path, int flags, ...)
+{
+	typedef int (*fn_type)(int, const char*, int, ...);
+	static const fn_type fn = next<fn_type>("openat");
+	va_list ap;
+	va_start(ap, flags);
+	const mode_t mode = mode_arg(flags, ap);
+	va_end(ap);
+	return opened(fn(dirfd, path, flags, mode), dirfd, path);
+}
+
+
+int openat64(int dirfd, const char *path, int flags, ...)
+{
+	typedef int (*fn_type)(int, const char*, int, ...);
+	static const fn_type fn = next<fn_type>("openat64");
+	va_list ap;
+	va_start(ap, flags);
+	const mode_t mode = mode_arg(flags, ap);
+	va_end(ap);
+	return opened(fn(dirfd, path, flags, mode), dirfd, path);
+}
+
+
+/*
+ * libstdc++ file streams open their files through fopen(), whose internal
+ * open() call is not interposable.
+ */
+FILE *fopen(const char *path, const char *mode)
+{
+	static const auto fn = next<FILE *(*)(const char*, const char*)>("fopen");
+	FILE *const f = fn(path, mode);
+	if (f)
+		opened(::fileno(f), AT_FDCWD, path);
+	return f;
+}
+
+
+FILE *fopen64(const char *path, const char *mode)
+{
+	static const auto fn = next<FILE *(*)(const char*, const char*)>("fopen64");
+	FILE *const f = fn(path, mode);
+	if (f)
+		opened(::fileno(f), AT_FDCWD, path);
+	return f;
+}
+
+
+int fclose(FILE *f)
+{
+	static const auto fn = next<int (*)(FILE*)>("fclose");
+	track(::fileno(f), false);
+	return fn(f);
+}
+
+
+int close(int fd)
+{
+	static const auto fn = next<int (*)(int)>("close");
+	track(fd, false);
+	return fn(fd);
+}
+
+
+ssize_t read(int fd, void *buf, size_t count)
+{
+	static const auto fn = next<ssize_t (*)(int, void*, size_t)>("read");
+	delay(fd, latency().read_us);
+	return fn(fd, buf, count);
+}
+
+
+ssize_t pread(int fd, void *buf, size_t count, off_t offset)
+{
+	static const auto fn = next<ssize_t (*)(int, void*, size_t, off_t)>("pread");
+	delay(fd, latency().read_us);
+	return fn(fd, buf, count, offset);
+}
+
+
+ssize_t pread64(int fd, void *buf, size_t count, off64_t offset)
+{
+	static const auto fn = next<ssize_t (*)(int, void*, size_t, off64_t)>("pread64");
+	delay(fd, latency().read_us);
+	return fn(fd, buf, count, offset);
+}
+
+
+ssize_t write(int fd, const void *buf, size_t count)
+{
+	static const auto fn = next<ssize_t (*)(int, const void*, size_t)>("write");
+	delay(fd, latency().write_us);
+	return fn(fd, buf, count);
+}
+
+
+ssize_t pwrite(int fd, const void *buf, size_t count, off_t offset)
+{
+	static const auto fn = next<ssize_t (*)(int, const void*, size_t, off_t)>("pwrite");
+	delay(fd, latency().write_us);
+	return fn(fd, buf, count, offset);
+}
+
+
+ssize_t pwrite64(int fd, const void *buf, size_t count, off64_t offset)
+{
+	static const auto fn = next<ssize_t (*)(int, const void*, size_t, off64_t)>("pwrite64");
+	delay(fd, latency().write_us);
+	return fn(fd, buf, count, offset);
+}
+
+}
@@ -0,0 +1,452 @@
+/*
+ * libsensors.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+/*
+ * A stand-in for the parts of libsensors used by sensors++, backed by a
+ * hwmon-style directory tree (see hwmon.hpp) instead of /sys/class/hwmon.
+ *
+ * Every directory "hwmon<N>" below the root is a chip named after the content
+ * of its "name" attribute, on the ISA bus at address N, with the directory as
+ * its path; with a "mock_virtual" attribute it's on the virtual bus at address
+ * 0 instead. Every "<type><n>_input" attribute for the types in, fan, temp,
+ * curr, energy and humidity forms a feature with an input subfeature, scaled
+ * like the libsensors sysfs backend does. The configuration file passed to
+ * sensors_init() is ignored.
+ */
+
+#include "environment.hpp"
+
+#include <sensors/sensors.h>
+#include <sensors/error.h>
+
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <cmath>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+extern "C" {
+
+const char *libsensors_version = "3.6.0 (" FANCONTROL_MOCK_VERSION_TAG ")";
+
+int sensors_sysfs_no_scaling = 0;
+
+}
+
+
+namespace {
+
+using fancontrol::mock::hwmon_root;
+namespace fs = boost::filesystem;
+
+
+struct feature_type_info {
+	const char *prefix;
+	sensors_feature_type type;
+	double scaling;
+};
+
+const feature_type_info feature_types[] = {
+	{ "in", SENSORS_FEATURE_IN, 1e3 },
+	{ "fan", SENSORS_FEATURE_FAN, 1 },
+	{ "temp", SENSORS_FEATURE_TEMP, 1e3 },
+	{ "energy", SENSORS_FEATURE_ENERGY, 1e6 },
+	{ "curr", SENSORS_FEATURE_CURR, 1e3 },
+	{ "humidity", SENSORS_FEATURE_HUMIDITY, 1e3 },
+};
+
+
+struct mock_chip
+{
+	sensors_chip_name name;
+
+	std::vector<sensors_feature> features;
+
+	std::vector<sensors_subfeature> subfeatures;
+
+	std::vector<double> scaling;
+
+	std::deque<std::string> strings;
+
+	char *keep(const std::string &s)
+	{
+		strings.push_back(s);
+		return &strings.back()[0];
+	}
+};
+
+std::vector< std::unique_ptr<mock_chip> > chips;
+
+
+bool read_line(const std::string &path, std::string &line)
+{
+	const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+
+	char buf[256];
+	const ssize_t n = ::pread(fd, buf, sizeof(buf) - 1, 0);
+	::close(fd);
+	if (n < 0)
+		return false;
+
+	line.assign(buf, static_cast<std::size_t>(n));
+	const std::string::size_type end = line.find_first_of("\r\n");
+	if (end != std::string::npos)
+		line.erase(end);
+	return true;
+}
+
+
+// "<prefix><n>_input" => type info and n
+const feature_type_info *parse_input_name(const std::string &name, int &number)
+{
+	static const char suffix[] = "_input";
+	const std::size_t suffix_len = sizeof(suffix) - 1;
+	if (name.size() <= suffix_len || name.compare(name.size() - suffix_len, suffix_len, suffix) != 0)
+		return nullptr;
+
+	for (const feature_type_info &t : feature_types) {
+		const std::size_t prefix_len = std::strlen(t.prefix);
+		if (name.compare(0, prefix_len, t.prefix) == 0) {
+			const std::string digits(name, prefix_len, name.size() - suffix_len - prefix_len);
+			if (digits.empty() || digits[0] < '1' || digits[0] > '9' ||
+				digits.find_first_not_of("0123456789") != std::string::npos)
+			{
+				return nullptr;
+			}
+			number = std::atoi(digits.c_str());
+			return &t;
+		}
+	}
+	return nullptr;
+}
+
+
+std::unique_ptr<mock_chip> scan_chip(const fs::path &dir, int addr)
+{
+	std::string prefix;
+	if (!read_line((dir / "name").native(), prefix) || prefix.empty())
+		return std::unique_ptr<mock_chip>();
+
+	std::unique_ptr<mock_chip> chip(new mock_chip);
+	chip->name.prefix = chip->keep(prefix);
+	const bool virtual_bus = ::access((dir / "mock_virtual").c_str(), F_OK) == 0;
+	chip->name.bus.type = virtual_bus ? SENSORS_BUS_TYPE_VIRTUAL : SENSORS_BUS_TYPE_ISA;
+	chip->name.bus.nr = 0;
+	chip->name.addr = virtual_bus ? 0 : addr;
+	chip->name.path = chip->keep(dir.native());
+
+	struct input {
+		const feature_type_info *info;
+		int number;
+		std::string name;
+		bool writable;
+
+		bool operator<(const input &o) const {
+			return (info->type != o.info->type) ? info->type < o.info->type : number < o.number;
+		}
+	};
+
+	std::vector<input> inputs;
+	for (fs::directory_iterator it(dir), end; it != end; ++it) {
+		const std::string name(it->path().filename().native());
+		input in;
+		in.info = parse_input_name(name, in.number);
+		if (in.info) {
+			in.name = name;
+			in.writable = ::access(it->path().c_str(), W_OK) == 0;
+			inputs.push_back(in);
+		}
+	}
+	std::sort(inputs.begin(), inputs.end());
+
+	for (const input &in : inputs) {
+		const int i = static_cast<int>(chip->features.size());
+		char name_buf[32];
+		std::snprintf(name_buf, sizeof(name_buf), "%s%d", in.info->prefix, in.number);
+
+		sensors_feature f;
+		std::memset(&f, 0, sizeof(f));
+		f.name = chip->keep(name_buf);
+		f.number = i;
+		f.type = in.info->type;
+		f.first_subfeature = i;
+		chip->features.push_back(f);
+
+		sensors_subfeature sf;
+		std::memset(&sf, 0, sizeof(sf));
+		sf.name = chip->keep(in.name);
+		sf.number = i;
+		sf.type = static_cast<sensors_subfeature_type>(in.info->type << 8);
+		sf.mapping = i;
+		sf.flags = SENSORS_MODE_R | SENSORS_COMPUTE_MAPPING |
+			(in.writable ? SENSORS_MODE_W : 0);
+		chip->subfeatures.push_back(sf);
+		chip->scaling.push_back(in.info->scaling);
+	}
+
+	return chip;
+}
+
+
+bool matches(const sensors_chip_name &match, const sensors_chip_name &chip)
+{
+	return (match.prefix == SENSORS_CHIP_NAME_PREFIX_ANY || std::strcmp(match.prefix, chip.prefix) == 0) &&
+		(match.bus.type == SENSORS_BUS_TYPE_ANY || match.bus.type == chip.bus.type) &&
+		(match.bus.nr == SENSORS_BUS_NR_ANY || match.bus.nr == chip.bus.nr) &&
+		(match.addr == SENSORS_CHIP_NAME_ADDR_ANY || match.addr == chip.addr);
+}
+
+
+const mock_chip *find_chip(const sensors_chip_name *name)
+{
+	if (name) {
+		for (const std::unique_ptr<mock_chip> &c : chips) {
+			if (c->name.bus.type == name->bus.type && c->name.bus.nr == name->bus.nr &&
+				c->name.addr == name->addr &&
+				(!name->prefix || std::strcmp(c->name.prefix, name->prefix) == 0))
+			{
+				return c.get();
+			}
+		}
+	}
+	return nullptr;
+}
+
+
+const sensors_subfeature *find_subfeature(const sensors_chip_name *name, int number, double *scaling)
+{
+	const mock_chip *const chip = find_chip(name);
+	if (!chip || number < 0 || static_cast<std::size_t>(number) >= chip->subfeatures.size())
+		return nullptr;
+	*scaling = chip->scaling[static_cast<std::size_t>(number)];
+	return &chip->subfeatures[static_cast<std::size_t>(number)];
+}
+
+
+std::string attribute_path(const sensors_chip_name *name, const sensors_subfeature &sf)
+{
+	std::string path(name->path);
+	path += '/';
+	path += sf.name;
+	return path;
+}
+
+}
+
+
+extern "C" {
+
+int sensors_init(FILE *)
+{
+	sensors_cleanup();
+
+	boost::system::error_code ec;
+	const fs::path root(hwmon_root());
+	fs::directory_iterator it(root, ec), end;
+	if (ec)
+		return -SENSORS_ERR_KERNEL;
+
+	std::vector< std::pair<int, fs::path> > dirs;
+	for (; it != end; it.increment(ec)) {
+		if (ec)
+			return -SENSORS_ERR_KERNEL;
+		const std::string name(it->path().filename().native());
+		if (name.compare(0, 5, "hwmon") == 0 && name.size() > 5 &&
+			name.find_first_not_of("0123456789", 5) == std::string::npos)
+		{
+			dirs.push_back(std::make_pair(std::atoi(name.c_str() + 5), it->path()));
+		}
+	}
+	std::sort(dirs.begin(), dirs.end());
+
+	for (const std::pair<int, fs::path> &d : dirs) {
+		std::unique_ptr<mock_chip> chip(scan_chip(d.second, d.first));
+		if (chip)
+			chips.push_back(std::move(chip));
+	}
+	return 0;
+}
+
+
+void sensors_cleanup(void)
+{
+	chips.clear();
+}
+
+
+int sensors_parse_chip_name(const char *orig_name, sensors_chip_name *res)
+{
+	std::memset(res, 0, sizeof(*res));
+	res->bus.type = SENSORS_BUS_TYPE_ANY;
+	res->bus.nr = SENSORS_BUS_NR_ANY;
+	res->addr = SENSORS_CHIP_NAME_ADDR_ANY;
+
+	const char *const dash = std::strchr(orig_name, '-');
+	const std::string prefix(orig_name, dash ? static_cast<std::size_t>(dash - orig_name) : std::strlen(orig_name));
+	if (prefix.empty())
+		return -SENSORS_ERR_CHIP_NAME;
+	if (prefix != "*")
+		res->prefix = strdup(prefix.c_str());
+
+	if (!dash || std::strcmp(dash + 1, "*") == 0)
+		return 0;
+
+	const char *const bus = dash + 1;
+	const char *const dash2 = std::strchr(bus, '-');
+	const std::string bus_name(bus, dash2 ? static_cast<std::size_t>(dash2 - bus) : 0);
+	if (bus_name == "isa") {
+		res->bus.type = SENSORS_BUS_TYPE_ISA;
+	} else if (bus_name == "virtual") {
+		res->bus.type = SENSORS_BUS_TYPE_VIRTUAL;
+	} else {
+		sensors_free_chip_name(res);
+		return -SENSORS_ERR_CHIP_NAME;
+	}
+	res->bus.nr = 0;
+
+	if (std::strcmp(dash2 + 1, "*") != 0) {
+		char *end;
+		const long addr = std::strtol(dash2 + 1, &end, 16);
+		if (*end != '\0' || end == dash2 + 1) {
+			sensors_free_chip_name(res);
+			return -SENSORS_ERR_CHIP_NAME;
+		}
+		res->addr = static_cast<int>(addr);
+	}
+	return 0;
+}
+
+
+void sensors_free_chip_name(sensors_chip_name *chip)
+{
+	std::free(chip->prefix);
+	std::free(chip->path);
+	chip->prefix = nullptr;
+	chip->path = nullptr;
+}
+
+
+const sensors_chip_name *sensors_get_detected_chips(const sensors_chip_name *match, int *nr)
+{
+	while (*nr >= 0 && static_cast<std::size_t>(*nr) < chips.size()) {
+		const sensors_chip_name &name = chips[static_cast<std::size_t>((*nr)++)]->name;
+		if (!match || matches(*match, name))
+			return &name;
+	}
+	return nullptr;
+}
+
+
+const sensors_feature *sensors_get_features(const sensors_chip_name *name, int *nr)
+{
+	const mock_chip *const chip = find_chip(name);
+	if (!chip || *nr < 0 || static_cast<std::size_t>(*nr) >= chip->features.size())
+		return nullptr;
+	return &chip->features[static_cast<std::size_t>((*nr)++)];
+}
+
+
+const sensors_subfeature *sensors_get_all_subfeatures(const sensors_chip_name *name,
+	const sensors_feature *feature, int *nr)
+{
+	// every feature has exactly one subfeature
+	const mock_chip *const chip = find_chip(name);
+	if (!chip || !feature || *nr != 0)
+		return nullptr;
+	(*nr)++;
+	return &chip->subfeatures[static_cast<std::size_t>(feature->first_subfeature)];
+}
+
+
+const sensors_subfeature *sensors_get_subfeature(const sensors_chip_name *name,
+	const sensors_feature *feature, sensors_subfeature_type type)
+{
+	const mock_chip *const chip = find_chip(name);
+	if (!chip || !feature)
+		return nullptr;
+	const sensors_subfeature &sf = chip->subfeatures[static_cast<std::size_t>(feature->first_subfeature)];
+	return (sf.type == type) ? &sf : nullptr;
+}
+
+
+int sensors_get_value(const sensors_chip_name *name, int subfeat_nr, double *value)
+{
+	double scaling;
+	const sensors_subfeature *const sf = find_subfeature(name, subfeat_nr, &scaling);
+	if (!sf)
+		return -SENSORS_ERR_NO_ENTRY;
+	if (!(sf->flags & SENSORS_MODE_R))
+		return -SENSORS_ERR_ACCESS_R;
+
+	std::string line;
+	if (!read_line(attribute_path(name, *sf), line))
+		return -SENSORS_ERR_KERNEL;
+
+	char *end;
+	const double raw = std::strtod(line.c_str(), &end);
+	if (end == line.c_str())
+		return -SENSORS_ERR_KERNEL;
+
+	*value = sensors_sysfs_no_scaling ? raw : raw / scaling;
+	return 0;
+}
+
+
+int sensors_set_value(const sensors_chip_name *name, int subfeat_nr, double value)
+{
+	double scaling;
+	const sensors_subfeature *const sf = find_subfeature(name, subfeat_nr, &scaling);
+	if (!sf)
+		return -SENSORS_ERR_NO_ENTRY;
+	if (!(sf->flags & SENSORS_MODE_W))
+		return -SENSORS_ERR_ACCESS_W;
+
+	char buf[32];
+	const int n = std::snprintf(buf, sizeof(buf), "%ld",
+		std::lround(sensors_sysfs_no_scaling ? value : value * scaling));
+	const int fd = ::open(attribute_path(name, *sf).c_str(), O_WRONLY | O_CLOEXEC);
+	if (fd < 0)
+		return -SENSORS_ERR_KERNEL;
+	const bool ok = ::pwrite(fd, buf, static_cast<std::size_t>(n), 0) == n;
+	::close(fd);
+	return ok ? 0 : -SENSORS_ERR_KERNEL;
+}
+
+
+const char *sensors_strerror(int errnum)
+{
+	static const char *const messages[] = {
+		"Unknown error",
+		"Wildcard found in chip name",
+		"No such subfeature known",
+		"Can't read",
+		"Kernel interface error",
+		"Divide by zero",
+		"Can't parse chip name",
+		"Can't parse bus name",
+		"General parse error",
+		"Can't write",
+		"I/O error",
+		"Evaluation recurses too deep",
+	};
+	if (errnum < 0)
+		errnum = -errnum;
+	return (static_cast<std::size_t>(errnum) < sizeof(messages) / sizeof(*messages)) ?
+		messages[errnum] : messages[0];
+}
+
+}
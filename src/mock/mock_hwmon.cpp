@@ -0,0 +1,94 @@
+/*
+ * mock_hwmon.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+/*
+ * fancontrol2-mock-hwmon: creates a mock hwmon tree and a matching
+ * configuration and prints the root to be used as FANCONTROL_MOCK_HWMON.
+ */
+
+#include "hwmon.hpp"
+#include "environment.hpp"
+
+#include <boost/exception/diagnostic_information.hpp>
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <unistd.h>
+
+
+namespace {
+
+void usage(const char *argv0, std::ostream &out)
+{
+	out << "Usage: " << argv0 << " [-c CHIPS] [-v VIRTUAL] [-t TEMPS] [-f FANS] [-p PWMS]"
+			" [-d DEPENDENCIES] [-i INTERVAL] [-o CONFIG] DIRECTORY\n"
+		"\n"
+		"Creates CHIPS (1) chips with TEMPS (2) temperature inputs, FANS (1) fan\n"
+		"inputs and PWMS (1) PWM outputs each below DIRECTORY, followed by VIRTUAL (0)\n"
+		"such chips that all share bus and address. With -o, writes a\n"
+		"configuration with one fan per PWM output that depends on DEPENDENCIES (2)\n"
+		"temperatures. Run fancontrol2_mock with " FANCONTROL_MOCK_HWMON_ENV "=DIRECTORY.\n";
+}
+
+}
+
+
+int main(int argc, char *argv[])
+{
+	typedef fancontrol::mock::hwmon_tree hwmon_tree;
+	unsigned chips = 1, virtual_chips = 0;
+	hwmon_tree::chip_spec spec;
+	hwmon_tree::config_options options;
+	const char *config_path = nullptr;
+
+	int opt;
+	while ((opt = ::getopt(argc, argv, "c:v:t:f:p:d:i:o:h")) != -1) {
+		switch (opt) {
+		case 'c': chips = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10)); break;
+		case 'v': virtual_chips = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10)); break;
+		case 't': spec.temps = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10)); break;
+		case 'f': spec.fans = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10)); break;
+		case 'p': spec.pwms = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10)); break;
+		case 'd': options.dependencies = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10)); break;
+		case 'i': options.interval = std::strtod(optarg, nullptr); break;
+		case 'o': config_path = optarg; break;
+		case 'h':
+			usage(argv[0], std::cout);
+			return EXIT_SUCCESS;
+		default:
+			usage(argv[0], std::cerr);
+			return EXIT_FAILURE;
+		}
+	}
+	if (optind + 1 != argc) {
+		usage(argv[0], std::cerr);
+		return EXIT_FAILURE;
+	}
+
+	try {
+		hwmon_tree tree(argv[optind]);
+		for (unsigned i = 0; i < chips; i++)
+			tree.add_chip(spec);
+		spec.virtual_bus = true;
+		for (unsigned i = 0; i < virtual_chips; i++)
+			tree.add_chip(spec);
+
+		if (config_path) {
+			std::ofstream config(config_path);
+			tree.write_config(config, options);
+			if (!config.flush()) {
+				std::cerr << "Couldn't write " << config_path << std::endl;
+				return EXIT_FAILURE;
+			}
+		}
+
+		std::cout << tree.root() << std::endl;
+	} catch (boost::exception &e) {
+		std::cerr << boost::diagnostic_information(e) << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,119 @@
+/*
+ * replay.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "replay.hpp"
+#include "config.hpp"
+#include "fan.hpp"
+#include "sensors++/pwm.hpp"
+#include "util/clock.hpp"
+
+#include <boost/throw_exception.hpp>
+#include <iostream>
+#include <stdexcept>
+#include <limits>
+#include <cstdlib>
+#include <cmath>
+
+
+namespace fancontrol {
+
+replay::replay(const config &cfg, const telemetry::trace &trace)
+	: m_cfg(cfg)
+	, m_trace(trace)
+{
+	const snapshot &samples = cfg.samples;
+	m_columns.reserve(samples.size());
+	for (snapshot::size_type i = 0; i < samples.size(); i++) {
+		const std::string name(samples.name(i));
+		const std::size_t column = trace.find(telemetry::sample_channel, name);
+		if (column == telemetry::trace::npos) {
+			BOOST_THROW_EXCEPTION(std::invalid_argument(
+				"The trace has no readings of " + name));
+		}
+		m_columns.push_back(column);
+	}
+
+	m_gauges.reserve(cfg.fans.size());
+	for (const config::fan_type &f : cfg.fans)
+		m_gauges.push_back(samples.index(*f->m_gauge.get()));
+}
+
+
+/*
+ * Only the snapshot values change between records; the plan is evaluated on
+ * a copy and the fans' decisions are taken with the static parts of their
+ * logic, so the configuration stays untouched.
+ */
+replay::result replay::run(std::ostream *out) const
+{
+	typedef fan::value_t value_t;
+	const config::fans_container &fans = m_cfg.fans;
+	control_plan plan(m_cfg.plan);
+	std::vector<snapshot::value_t> samples(m_columns.size());
+	std::vector<value_t> last(fans.size(), std::numeric_limits<value_t>::quiet_NaN());
+	const value_t pwm_max = static_cast<value_t>(sensors::pwm::pwm_max());
+
+	if (out) {
+		*out << "sequence,time";
+		for (const config::fan_type &f : fans)
+			*out << ',' << *f->m_label;
+		*out << '\n';
+	}
+
+	result r = { 0, 0, 0 };
+	const util::real_clock clock;
+	const double start = clock.seconds();
+
+	for (std::size_t i = 0; i < m_trace.size(); i++) {
+		const float *const values = m_trace.values(i);
+		for (std::size_t k = 0; k < m_columns.size(); k++)
+			samples[k] = values[m_columns[k]];
+		plan.evaluate(samples.data());
+
+		bool written = false;
+		for (config::fans_container::size_type k = 0; k < fans.size(); k++) {
+			const control_plan::index_type node = m_cfg.fan_node(k);
+			if (node == control_plan::npos)
+				continue;
+
+			const fan &f = *fans[k];
+			const value_t value = fan::effective_value(
+				plan.rate(node), samples[m_gauges[k]], f.m_min_start, f.m_max_stop);
+			if (fan::needs_update(value, last[k])) {
+				last[k] = value;
+				r.writes++;
+				written = true;
+			}
+		}
+
+		if (written && out) {
+			const telemetry::record_header &rh = m_trace.record(i);
+			telemetry::write_time(*out << rh.sequence << ',', rh.time_ns);
+			for (const value_t value : last) {
+				*out << ',';
+				if (!std::isnan(value))
+					*out << std::lround(value * pwm_max);
+			}
+			*out << '\n';
+		}
+	}
+
+	r.ticks = m_trace.size();
+	r.seconds = clock.seconds() - start;
+	return r;
+}
+
+
+int replay::run(std::ostream &out, std::ostream &log) const
+{
+	const result r = run(&out);
+	out.flush();
+	log << "Replayed " << r.ticks << " ticks with " << r.writes << " PWM writes in "
+		<< r.seconds << " s (" << (static_cast<double>(r.ticks) / r.seconds) << " ticks/s)" << std::endl;
+	return out ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} /* namespace fancontrol */
@@ -0,0 +1,66 @@
+/*
+ * replay.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef FANCONTROL_REPLAY_HPP_
+#define FANCONTROL_REPLAY_HPP_
+
+#include "telemetry.hpp"
+#include <vector>
+#include <iosfwd>
+
+
+namespace fancontrol {
+
+class config;
+
+
+/*
+ * Runs the control graph of a configuration against the sensor readings of a
+ * recorded telemetry trace instead of the hardware: every record is
+ * evaluated like a tick, and the PWM values the fans would have been written
+ * are reported. Nothing is read from or written to the sensors.
+ *
+ * Sources and fan gauges are bound to the trace's sample channels by name,
+ * so the configuration must resolve to the chips the trace was recorded on.
+ */
+class replay
+{
+public:
+	replay(const config &cfg, const telemetry::trace &trace);
+
+	struct result
+	{
+		unsigned long ticks;
+
+		// PWM values that would have been written
+		unsigned long writes;
+
+		double seconds;
+	};
+
+	/*
+	 * With an output stream, writes a CSV row with the raw PWM value of
+	 * every fan for each tick with a write.
+	 */
+	result run(std::ostream *out) const;
+
+	int run(std::ostream &out, std::ostream &log) const;
+
+private:
+	const config &m_cfg;
+
+	const telemetry::trace &m_trace;
+
+	// trace channel of each sample of the configuration
+	std::vector<std::size_t> m_columns;
+
+	// sample of each fan's gauge
+	std::vector<std::size_t> m_gauges;
+};
+
+} /* namespace fancontrol */
+#endif /* FANCONTROL_REPLAY_HPP_ */
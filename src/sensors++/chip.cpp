@@ -8,12 +8,13 @@
 #include "chip.hpp"
 #include "feature.hpp"
 #include "pwm.hpp"
+#include "internal/hwmon_index.hpp"
 #include "util/algorithm.hpp"
 #include "util/stringpiece/lexical_cast.hpp"
 
-#include <boost/filesystem.hpp>
 #include <boost/foreach.hpp>
 #include <boost/assert.hpp>
+#include <algorithm>
 #include <cstring>
 
 
@@ -71,31 +72,16 @@ typename rebind_ptr<chip::feature_map_type>::other chip::discover_features()
 
 typename rebind_ptr<chip::pwm_map_type>::other chip::discover_pwms()
 {
-	namespace fs = boost::filesystem;
-	using std::string;
-
-	const string_ref &prefix = pwm::Item::prefix();
-	BOOST_ASSERT(!prefix.empty());
-
 	typedef typename rebind_ptr<pwm_map_type>::other map_type;
 	map_type map;
-	fs::path chip_path(this->path().begin(), this->path().end());
-	for (fs::directory_iterator it(chip_path), end; it != end; ++it)
-	{
-		const fs::path feature_path(it->path().filename());
-		const string &feature_name = feature_path.native();
-		if (util::has_prefix(feature_name, prefix))
-		{
-			const string_ref number_str(feature_name.data() + prefix.length());
-			if (starts_with_nonzero_digit(number_str)) {
-				util::streamstate streamstate;
-				const unsigned index = util::lexical_cast<unsigned>(number_str, &streamstate);;
-				if (streamstate.first & std::ios::eofbit) {
-					shared_ptr<pwm_t> p(pwm(index));
-					if (p) {
-						BOOST_ASSERT(map.count(index) == 0);
-						map[index] = std::move(p);
-					}
+	if (!!*this) {
+		const hwmon_index::pwm_list *const numbers = lock::instance()->index().pwms(*get());
+		if (numbers) {
+			BOOST_FOREACH(const unsigned index, *numbers) {
+				shared_ptr<pwm_t> p(pwm(index));
+				if (p) {
+					BOOST_ASSERT(map.count(index) == 0);
+					map[index] = std::move(p);
 				}
 			}
 		}
@@ -111,6 +97,11 @@ shared_ptr<pwm> chip::pwm(unsigned number)
 		if (!p.expired())
 			return p.lock();
 
+		// Outputs of detected chips are known; others have to be probed.
+		const hwmon_index::pwm_list *const numbers = lock::instance()->index().pwms(*get());
+		if (numbers && !std::binary_search(numbers->begin(), numbers->end(), number))
+			return shared_ptr<pwm_t>();
+
 		shared_ptr<pwm_t> p_new(util::make_shared<pwm_t>(
 				number, shared_from_this()));
 		if (p_new->exists()) {
@@ -131,29 +122,14 @@ shared_ptr<feature> chip::feature(const feature_map_type::key_type &key)
 			return ft.lock();
 
 		if (!!*this) {
-			const string_ref &prefix = feat_t::Types::name(key.first);
-			BOOST_ASSERT(!prefix.empty());
-			int nr = 0;
-			const feat_t::basic_type *ft_basic;
-			while (!!(ft_basic = sensors_get_features(get(), &nr))) {
-				if (ft_basic->type == key.first) {
-					BOOST_ASSERT(prefix.prefix_of(ft_basic->name));
-
-					const string_ref number_str(ft_basic->name + prefix.length());
-					BOOST_ASSERT(starts_with_nonzero_digit(number_str));
-
-					util::streamstate streamstate;
-					const int number = util::lexical_cast<int>(number_str, &streamstate);
-					BOOST_ASSERT(streamstate.first & std::ios::eofbit);
-
-					if (number == key.second) {
-						shared_ptr<feat_t> ft_new(util::make_shared<feat_t>(
-							ft_basic, string_ref(ft_basic->name, number_str.end()),
-							shared_from_this(), feat_t::key1()));
-						ft = ft_new;
-						return ft_new;
-					}
-				}
+			const feat_t::basic_type *const ft_basic =
+				lock::instance()->index().feature(*get(), key.first, key.second);
+			if (ft_basic) {
+				shared_ptr<feat_t> ft_new(util::make_shared<feat_t>(
+					ft_basic, string_ref(ft_basic->name),
+					shared_from_this(), feat_t::key1()));
+				ft = ft_new;
+				return ft_new;
 			}
 		}
 	}
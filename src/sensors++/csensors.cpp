@@ -1,6 +1,7 @@
 #include "csensors.hpp"
 #include <boost/functional/hash.hpp>
 #include <boost/assert.hpp>
+#include <boost/preprocessor/stringize.hpp>
 #include <cstring>
 
 
@@ -9,7 +10,11 @@ namespace sensors {
 using std::size_t;
 
 
-const char *const default_config_path = "/etc/sensors3.conf";
+#ifndef SENSORS_DEFAULT_CONFIG_PATH
+#	define SENSORS_DEFAULT_CONFIG_PATH /etc/sensors3.conf
+#endif
+
+const char *const default_config_path = BOOST_PP_STRINGIZE(SENSORS_DEFAULT_CONFIG_PATH);
 
 
 namespace helper {
@@ -19,6 +24,22 @@ namespace helper {
 		return a == b || (a && b && std::strcmp(a, b) == 0);
 	}
 
+
+	size_t chip_identity_hash::operator()(const sensors_chip_name &name) const
+	{
+		size_t seed = hash_value(name);
+		if (name.prefix)
+			boost::hash_range(seed, name.prefix, name.prefix + std::strlen(name.prefix));
+		boost::hash_combine(seed, name.bus.type);
+		return seed;
+	}
+
+
+	bool chip_identity_equal::operator()(const sensors_chip_name &a, const sensors_chip_name &b) const
+	{
+		return helper::equals(a, b) && a.bus.type == b.bus.type && equals(a.prefix, b.prefix);
+	}
+
 }
 
 
@@ -28,6 +28,22 @@ namespace helper {
 
 	bool equals(const char *a, const char *b);
 
+
+	/*
+	 * Hash and equality over prefix, bus type, bus number and address. The
+	 * operators above look at the bus number and address only, which all ACPI
+	 * and virtual chips share.
+	 */
+	struct chip_identity_hash
+	{
+		std::size_t operator()(const sensors_chip_name &name) const;
+	};
+
+	struct chip_identity_equal
+	{
+		bool operator()(const sensors_chip_name &a, const sensors_chip_name &b) const;
+	};
+
 }
 
 
@@ -9,6 +9,7 @@
 #include "feature.hpp"
 #include "subfeature.hpp"
 #include "chip.hpp"
+#include "internal/hwmon_index.hpp"
 
 #include "util/algorithm.hpp"
 #include "util/stringpiece/lexical_cast.hpp"
@@ -46,7 +47,7 @@ shared_ptr<subfeature> feature::subfeature(subfeature::type_enum type)
 		return sf.lock();
 
 	if (!!*this && parent() && !!*parent()) {
-		const SF::basic_type *sf_basic = sensors_get_subfeature(parent()->get(), get(), type);
+		const SF::basic_type *sf_basic = lock::instance()->index().subfeature(get(), type);
 		if (sf_basic) {
 			shared_ptr<SF> sf_new(util::make_shared<SF>(
 					sf_basic, shared_from_this()));
@@ -0,0 +1,172 @@
+/*
+ * hwmon_index.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "hwmon_index.hpp"
+#include "../feature.hpp"
+#include "../pwm.hpp"
+
+#include "util/algorithm.hpp"
+#include "util/stringpiece/lexical_cast.hpp"
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <cstdint>
+
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+namespace sensors {
+
+namespace {
+
+	// the kernel's record, which glibc before 2.30 doesn't declare
+	struct dirent64_record
+	{
+		std::uint64_t d_ino;
+		std::int64_t d_off;
+		unsigned short d_reclen;
+		unsigned char d_type;
+		char d_name[];
+	};
+
+
+	// the number after prefix, or 0 unless the rest of name is a positive decimal
+	template <typename Number>
+	Number parse_number(const string_ref &name, const string_ref &prefix)
+	{
+		if (util::has_prefix(name, prefix)) {
+			const string_ref number_str(name.substr(prefix.size()));
+			if (starts_with_nonzero_digit(number_str)) {
+				util::streamstate streamstate;
+				const Number number = util::lexical_cast<Number>(number_str, &streamstate);
+				if (streamstate.first & std::ios::eofbit)
+					return number;
+			}
+		}
+		return 0;
+	}
+
+}
+
+
+hwmon_index::hwmon_index()
+{
+	const sensors_chip_name *name;
+	int nr = 0;
+	while (!!(name = sensors_get_detected_chips(nullptr, &nr)))
+		add_chip(name);
+}
+
+
+void hwmon_index::add_chip(const sensors_chip_name *name)
+{
+	const std::size_t i = m_chips.size();
+	m_chips.push_back(chip_entry());
+	chip_entry &entry = m_chips.back();
+	entry.name = name;
+
+	m_chip_by_name.emplace(*name, i);
+	if (name->prefix)
+		m_chips_by_prefix[name->prefix].push_back(i);
+
+	add_features(i);
+	if (name->path)
+		scan_pwms(name->path, entry.pwms);
+}
+
+
+void hwmon_index::add_features(std::size_t chip)
+{
+	const sensors_chip_name *const name = m_chips[chip].name;
+	const sensors_feature *ft;
+	int nr = 0;
+	while (!!(ft = sensors_get_features(name, &nr))) {
+		const int number = parse_number<int>(string_ref(ft->name), feature::Types::name(ft->type));
+		if (number != 0)
+			m_features.emplace(feature_key(chip, std::make_pair(ft->type, number)), ft);
+
+		const sensors_subfeature *sf;
+		int sf_nr = 0;
+		while (!!(sf = sensors_get_all_subfeatures(name, ft, &sf_nr)))
+			m_subfeatures.emplace(subfeature_key(ft, sf->type), sf);
+	}
+}
+
+
+/*
+ * Reads the directory with getdents64 in large batches instead of one
+ * readdir and one allocated path per entry. A chip without a readable
+ * directory just has no PWM outputs.
+ */
+void hwmon_index::scan_pwms(const char *path, pwm_list &pwms)
+{
+	const int fd = ::open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (fd < 0)
+		return;
+
+	const string_ref &prefix = pwm::Item::prefix();
+	alignas(dirent64_record) char buf[16384];
+	long n;
+	while ((n = ::syscall(SYS_getdents64, fd, buf, sizeof(buf))) > 0) {
+		for (long pos = 0; pos < n; ) {
+			const dirent64_record *const d = reinterpret_cast<const dirent64_record*>(buf + pos);
+			pos += d->d_reclen;
+
+			const unsigned number = parse_number<unsigned>(string_ref(d->d_name), prefix);
+			if (number != 0)
+				pwms.push_back(number);
+		}
+	}
+	::close(fd);
+
+	std::sort(pwms.begin(), pwms.end());
+}
+
+
+const hwmon_index::chip_list &hwmon_index::chips(const string_ref &prefix) const
+{
+	static const chip_list none;
+	const auto it = m_chips_by_prefix.find(prefix.str());
+	return (it != m_chips_by_prefix.end()) ? it->second : none;
+}
+
+
+const sensors_chip_name *hwmon_index::chip(const sensors_chip_name &name) const
+{
+	const auto it = m_chip_by_name.find(name);
+	return (it != m_chip_by_name.end()) ? m_chips[it->second].name : nullptr;
+}
+
+
+const sensors_feature *hwmon_index::feature(const sensors_chip_name &chip,
+	sensors_feature_type type, int number) const
+{
+	const auto it_chip = m_chip_by_name.find(chip);
+	if (it_chip != m_chip_by_name.end()) {
+		const auto it = m_features.find(feature_key(it_chip->second, std::make_pair(type, number)));
+		if (it != m_features.end())
+			return it->second;
+	}
+	return nullptr;
+}
+
+
+const sensors_subfeature *hwmon_index::subfeature(const sensors_feature *feature,
+	sensors_subfeature_type type) const
+{
+	const auto it = m_subfeatures.find(subfeature_key(feature, type));
+	return (it != m_subfeatures.end()) ? it->second : nullptr;
+}
+
+
+const hwmon_index::pwm_list *hwmon_index::pwms(const sensors_chip_name &chip) const
+{
+	const auto it = m_chip_by_name.find(chip);
+	return (it != m_chip_by_name.end()) ? &m_chips[it->second].pwms : nullptr;
+}
+
+} /* namespace sensors */
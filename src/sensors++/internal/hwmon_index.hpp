@@ -0,0 +1,112 @@
+/*
+ * hwmon_index.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef SENSORS_HWMON_INDEX_HPP_
+#define SENSORS_HWMON_INDEX_HPP_
+
+#include "common.hpp"
+#include "../csensors.hpp"
+
+#include <boost/functional/hash.hpp>
+#include <boost/noncopyable.hpp>
+#include <unordered_map>
+#include <utility>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+
+namespace sensors {
+
+/*
+ * Every detected chip with its features, subfeatures and PWM outputs, gathered
+ * in one pass and looked up by hash. Chips, features and subfeatures are
+ * libsensors' own objects, which stay valid until libsensors is released; the
+ * PWM outputs come from one getdents64 walk over each chip's directory.
+ *
+ * Features are keyed by the number in their name, like chip::feature, and
+ * chips by their prefix or their complete name, including the prefix and
+ * bus type (see helper::chip_identity_hash).
+ */
+class hwmon_index
+	: boost::noncopyable
+{
+public:
+	typedef std::vector<std::size_t> chip_list;
+
+	typedef std::vector<unsigned> pwm_list;
+
+	hwmon_index();
+
+	// in libsensors' order
+	const chip_list &chips(const string_ref &prefix) const;
+
+	const sensors_chip_name &chip(std::size_t i) const;
+
+	// the detected chip of that exact name, or nullptr
+	const sensors_chip_name *chip(const sensors_chip_name &name) const;
+
+	const sensors_feature *feature(const sensors_chip_name &chip,
+		sensors_feature_type type, int number) const;
+
+	const sensors_subfeature *subfeature(const sensors_feature *feature,
+		sensors_subfeature_type type) const;
+
+	// ascending; nullptr if the chip wasn't detected
+	const pwm_list *pwms(const sensors_chip_name &chip) const;
+
+	std::size_t size() const;
+
+private:
+	struct chip_entry
+	{
+		const sensors_chip_name *name;
+
+		pwm_list pwms;
+	};
+
+	typedef std::pair<std::size_t, std::pair<int, int> > feature_key;
+
+	typedef std::pair<const sensors_feature*, int> subfeature_key;
+
+	void add_chip(const sensors_chip_name *name);
+
+	void add_features(std::size_t chip);
+
+	static void scan_pwms(const char *path, pwm_list &pwms);
+
+	std::vector<chip_entry> m_chips;
+
+	std::unordered_map<sensors_chip_name, std::size_t,
+		helper::chip_identity_hash, helper::chip_identity_equal> m_chip_by_name;
+
+	std::unordered_map<std::string, chip_list> m_chips_by_prefix;
+
+	std::unordered_map<feature_key, const sensors_feature*, boost::hash<feature_key> > m_features;
+
+	std::unordered_map<subfeature_key, const sensors_subfeature*, boost::hash<subfeature_key> > m_subfeatures;
+};
+
+
+
+// implementations ========================================
+
+inline
+const sensors_chip_name &hwmon_index::chip(std::size_t i) const
+{
+	return *m_chips[i].name;
+}
+
+
+inline
+std::size_t hwmon_index::size() const
+{
+	return m_chips.size();
+}
+
+} /* namespace sensors */
+#endif /* SENSORS_HWMON_INDEX_HPP_ */
@@ -6,6 +6,7 @@
  */
 
 #include "lock.hpp"
+#include "hwmon_index.hpp"
 #include "util/assert.hpp"
 #include <cerrno>
 
@@ -100,6 +101,7 @@ sensor_error::type_enum lock::init(const char *config)
 sensor_error::type_enum lock::init_internal(const char *config)
 {
 	std::FILE *const f = helper::fopen_stat(config, &m_config_file_stat);
+	m_index.reset();
 	sensor_error::type_enum r = sensor_error::to_enum(sensors_init(f));
 	m_initialized = r == sensor_error::no_error;
 
@@ -118,9 +120,22 @@ bool lock::same_config_file(const char *f) const
 }
 
 
+/*
+ * Without libsensors nothing is detected, and the index is as empty as a scan
+ * would be; callers then report the missing chips themselves.
+ */
+const hwmon_index &lock::index()
+{
+	if (!m_index)
+		m_index.reset(new hwmon_index());
+	return *m_index;
+}
+
+
 void lock::release()
 {
 	if (initialized()) {
+		m_index.reset();
 		m_initialized = false;
 		sensors_cleanup();
 	}
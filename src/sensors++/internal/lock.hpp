@@ -13,6 +13,7 @@
 #include "../exceptions.hpp"
 #include <stdexcept>
 #include "util/memory.hpp"
+#include <memory>
 #include <cstdio>
 #include <sys/stat.h>
 
@@ -22,6 +23,8 @@ namespace sensors {
 using util::shared_ptr;
 using util::io_error;
 
+class hwmon_index;
+
 
 class lock
 {
@@ -38,6 +41,9 @@ public:
 
 	bool same_config_file(const char *f) const;
 
+	// built on first use after each initialisation
+	const hwmon_index &index();
+
 	class auto_lock {
 	public:
 		auto_lock();
@@ -57,6 +63,8 @@ private:
 	sensor_error::type_enum init_internal(const char *config);
 
 	struct stat m_config_file_stat;
+
+	std::unique_ptr<hwmon_index> m_index;
 };
 
 
@@ -0,0 +1,191 @@
+/*
+ * sysfs_attribute.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "sysfs_attribute.hpp"
+#include "util/algorithm.hpp"
+#include <boost/assert.hpp>
+#include <utility>
+#include <cerrno>
+#include <cstdlib>
+#include <unistd.h>
+
+
+namespace sensors {
+
+sysfs_attribute::sysfs_attribute()
+	: m_flags(O_RDONLY)
+	, m_fd(-1)
+{
+}
+
+
+sysfs_attribute::sysfs_attribute(const std::string &path, int flags)
+	: m_path(path)
+	, m_flags(flags)
+	, m_fd(-1)
+{
+}
+
+
+sysfs_attribute::sysfs_attribute(sysfs_attribute &&other)
+	: m_path(std::move(other.m_path))
+	, m_flags(other.m_flags)
+	, m_fd(other.m_fd)
+{
+	other.m_fd = -1;
+}
+
+
+sysfs_attribute &sysfs_attribute::operator=(sysfs_attribute &&other)
+{
+	if (&other != this) {
+		close();
+		m_path = std::move(other.m_path);
+		m_flags = other.m_flags;
+		m_fd = other.m_fd;
+		other.m_fd = -1;
+	}
+	return *this;
+}
+
+
+sysfs_attribute::~sysfs_attribute()
+{
+	close();
+}
+
+
+void sysfs_attribute::assign(const std::string &path, int flags)
+{
+	close();
+	m_path = path;
+	m_flags = flags;
+}
+
+
+int sysfs_attribute::open()
+{
+	BOOST_ASSERT(!m_path.empty());
+	if (m_fd < 0) {
+		m_fd = ::open(m_path.c_str(), m_flags | O_CLOEXEC);
+		if (m_fd < 0)
+			return errno;
+	}
+	return 0;
+}
+
+
+void sysfs_attribute::close()
+{
+	if (m_fd >= 0) {
+		::close(m_fd);
+		m_fd = -1;
+	}
+}
+
+
+bool sysfs_attribute::is_stale(int errnum)
+{
+	static const int stale_errnos[] = {
+		ENODEV, ENXIO, ENOENT, ESTALE, EBADF
+	};
+	return util::any_of_equal(stale_errnos, errnum);
+}
+
+
+template <typename Operation>
+ssize_t sysfs_attribute::access(Operation op)
+{
+	int errnum = open();
+	if (errnum == 0) {
+		const ssize_t r = op(m_fd);
+		if (r >= 0 || !is_stale(errno))
+			return r;
+
+		// the device may have gone away and come back; try again once
+		close();
+		errnum = open();
+		if (errnum == 0)
+			return op(m_fd);
+	}
+	errno = errnum;
+	return -1;
+}
+
+
+ssize_t sysfs_attribute::read(char *buf, std::size_t size)
+{
+	return access([buf, size](int fd) { return ::pread(fd, buf, size, 0); });
+}
+
+
+ssize_t sysfs_attribute::write(const char *buf, std::size_t size)
+{
+	return access([buf, size](int fd) { return ::pwrite(fd, buf, size, 0); });
+}
+
+
+int sysfs_attribute::read(unsigned &value)
+{
+	buffer_type buf;
+	const ssize_t n = read(buf, sizeof(buf) - 1);
+	if (n < 0)
+		return errno;
+
+	buf[n] = '\0';
+	char *end;
+	errno = 0;
+	const unsigned long v = std::strtoul(buf, &end, 10);
+	if (end == buf || errno != 0 || v > static_cast<unsigned long>(static_cast<unsigned>(-1)))
+		return (errno != 0) ? errno : EINVAL;
+
+	value = static_cast<unsigned>(v);
+	return 0;
+}
+
+
+int sysfs_attribute::read(double &value)
+{
+	buffer_type buf;
+	const ssize_t n = read(buf, sizeof(buf) - 1);
+	if (n < 0)
+		return errno;
+
+	buf[n] = '\0';
+	return parse(buf, value);
+}
+
+
+int sysfs_attribute::parse(const char *buf, double &value)
+{
+	char *end;
+	errno = 0;
+	const double v = std::strtod(buf, &end);
+	if (end == buf || errno != 0)
+		return (errno != 0) ? errno : EINVAL;
+
+	value = v;
+	return 0;
+}
+
+
+int sysfs_attribute::write(unsigned value)
+{
+	buffer_type buf;
+	char *p = buf + sizeof(buf);
+	do {
+		*--p = static_cast<char>('0' + value % 10);
+		value /= 10;
+	} while (value != 0);
+
+	const std::size_t size = static_cast<std::size_t>(buf + sizeof(buf) - p);
+	const ssize_t n = write(p, size);
+	if (n < 0)
+		return errno;
+	return (static_cast<std::size_t>(n) == size) ? 0 : EIO;
+}
+
+} /* namespace sensors */
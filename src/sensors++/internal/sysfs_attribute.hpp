@@ -0,0 +1,120 @@
+/*
+ * sysfs_attribute.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef SENSORS_SYSFS_ATTRIBUTE_HPP_
+#define SENSORS_SYSFS_ATTRIBUTE_HPP_
+
+#include "common.hpp"
+#include <string>
+#include <cstddef>
+#include <fcntl.h>
+#include <sys/types.h>
+
+
+namespace sensors {
+
+/*
+ * A sysfs attribute file that is kept open between accesses. Reads and writes
+ * always happen at offset 0 via pread/pwrite, so the kernel regenerates the
+ * attribute content for every access. If the underlying device vanished and
+ * reappeared, the file is reopened transparently and the access is retried
+ * once.
+ *
+ * Errors are reported as (positive) errno values instead of exceptions, so
+ * callers can decide whether to throw.
+ */
+class sysfs_attribute
+{
+public:
+	typedef char buffer_type[32];
+
+	sysfs_attribute();
+
+	explicit sysfs_attribute(const std::string &path, int flags = O_RDONLY);
+
+	sysfs_attribute(sysfs_attribute &&other);
+
+	sysfs_attribute &operator=(sysfs_attribute &&other);
+
+	~sysfs_attribute();
+
+	void assign(const std::string &path, int flags = O_RDONLY);
+
+	const std::string &path() const;
+
+	int flags() const;
+
+	int fd() const;
+
+	bool is_open() const;
+
+	int open();
+
+	void close();
+
+	ssize_t read(char *buf, std::size_t size);
+
+	ssize_t write(const char *buf, std::size_t size);
+
+	int read(unsigned &value);
+
+	int read(double &value);
+
+	int write(unsigned value);
+
+	static int parse(const char *buf, double &value);
+
+	static bool is_stale(int errnum);
+
+private:
+	sysfs_attribute(const sysfs_attribute&) = delete;
+
+	sysfs_attribute &operator=(const sysfs_attribute&) = delete;
+
+	template <typename Operation>
+	ssize_t access(Operation op);
+
+	std::string m_path;
+
+	int m_flags;
+
+	int m_fd;
+};
+
+
+
+// implementations ========================================
+
+inline
+const std::string &sysfs_attribute::path() const
+{
+	return m_path;
+}
+
+
+inline
+int sysfs_attribute::flags() const
+{
+	return m_flags;
+}
+
+
+inline
+int sysfs_attribute::fd() const
+{
+	return m_fd;
+}
+
+
+inline
+bool sysfs_attribute::is_open() const
+{
+	return m_fd >= 0;
+}
+
+} /* namespace sensors */
+#endif /* SENSORS_SYSFS_ATTRIBUTE_HPP_ */
@@ -17,6 +17,7 @@
 #include <limits>
 #include <stdexcept>
 #include <cstring>
+#include <cerrno>
 #include <unistd.h>
 
 
@@ -29,6 +30,7 @@ pwm::pwm(const string_ref &path)
 	: m_chip()
 	, m_basepath(path.str())
 	, m_number(0)
+	, m_keep_open(false)
 {
 	init();
 }
@@ -38,6 +40,7 @@ pwm::pwm(int number, const shared_ptr<chip_t> &chip)
 	: m_chip(chip)
 	, m_basepath(make_basepath(*chip, number))
 	, m_number(number)
+	, m_keep_open(false)
 {
 	init();
 }
@@ -109,7 +112,7 @@ pwm::value_t pwm::raw_value() const
 	const pwm *p = (m_number == 2 && m_chip && m_chip->quirks()[chip::Quirks::pwm2_alters_pwm1]) ?
 			UTIL_CHECK_POINTER(m_associated) : this;
 
-	return p->value_read(Item::name(Item::pwm));
+	return p->value_read(Item::pwm);
 }
 
 
@@ -130,7 +133,7 @@ pwm::enable_enum pwm::enable(value_t *raw) const
 
 pwm::value_t pwm::value(item_enum item) const
 {
-	return (item != Item::pwm) ? value_read(Item::name(item)) : raw_value();
+	return (item != Item::pwm) ? value_read(item) : raw_value();
 }
 
 
@@ -158,15 +161,60 @@ pwm::value_t pwm::value_read(const string_ref &item, bool ignore_value) const
 }
 
 
-void pwm::raw_value(value_t value)
+pwm::value_t pwm::value_read(item_enum item, bool ignore_value) const
+{
+	if (!m_keep_open)
+		return value_read(Item::name(item), ignore_value);
+
+	value_t value = 0;
+	const int errnum = read_item(item, !ignore_value ? &value : nullptr);
+	if (errnum != 0)
+		throw_attribute_error(attribute(item), errnum, "Could not read PWM attribute");
+	return value;
+}
+
+
+/*
+ * Without keep_open, the attribute is opened for this access only, but
+ * still without the iostream machinery and its exceptions.
+ */
+int pwm::read_item(item_enum item, value_t *value) const
+{
+	sysfs_attribute once;
+	sysfs_attribute *attr = &once;
+	if (m_keep_open) {
+		attr = &attribute(item);
+	} else {
+		itempath_buffer_type buf;
+		once.assign(make_itempath(Item::name(item), buf), O_RDONLY);
+	}
+
+	if (value)
+		return attr->read(*value);
+
+	sysfs_attribute::buffer_type buf;
+	return (attr->read(buf, sizeof(buf)) >= 0) ? 0 : errno;
+}
+
+
+int pwm::write_item(item_enum item, value_t value)
 {
-	const string_ref &item = Item::name(Item::pwm);
+	if (m_keep_open)
+		return attribute(item).write(value);
+
+	itempath_buffer_type buf;
+	sysfs_attribute once(make_itempath(Item::name(item), buf), O_WRONLY);
+	return once.write(value);
+}
 
+
+void pwm::raw_value(value_t value)
+{
 	if (m_chip && m_chip->quirks()[chip::Quirks::pwm_read_before_write]) {
-		value_read(item, true);
+		value_read(Item::pwm, true);
 	}
 
-	value_write(item, std::min(value, pwm_max()));
+	value_write(Item::pwm, std::min(value, pwm_max()));
 }
 
 
@@ -176,9 +224,22 @@ void pwm::value(rate_t value)
 }
 
 
+int pwm::write(rate_t value)
+{
+	if (m_chip && m_chip->quirks()[chip::Quirks::pwm_read_before_write]) {
+		const int errnum = read_item(Item::pwm, nullptr);
+		if (errnum != 0)
+			return errnum;
+	}
+
+	const value_t raw = static_cast<value_t>(std::max<rate_t>(value, 0) * static_cast<rate_t>(pwm_max()) + 0.5f);
+	return write_item(Item::pwm, std::min(raw, pwm_max()));
+}
+
+
 void pwm::value(item_enum item, value_t value)
 {
-	return (item != Item::pwm) ? value_write(Item::name(item), value) : raw_value(value);
+	return (item != Item::pwm) ? value_write(item, value) : raw_value(value);
 }
 
 
@@ -197,6 +258,55 @@ void pwm::value_write(const string_ref &item, value_t value)
 }
 
 
+void pwm::value_write(item_enum item, value_t value)
+{
+	if (!m_keep_open)
+		return value_write(Item::name(item), value);
+
+	const int errnum = write_item(item, value);
+	if (errnum != 0)
+		throw_attribute_error(attribute(item), errnum, "Could not write PWM attribute");
+}
+
+
+sysfs_attribute &pwm::attribute(item_enum item) const
+{
+	BOOST_ASSERT(item >= 0 && item < Item::_length);
+	sysfs_attribute &attr = m_attributes[item];
+	if (attr.path().empty()) {
+		itempath_buffer_type buf;
+		attr.assign(make_itempath(Item::name(item), buf), O_RDWR);
+		if (attr.open() == EACCES) {
+			// some attributes are read-only
+			attr.assign(attr.path(), O_RDONLY);
+		}
+	}
+	return attr;
+}
+
+
+void pwm::throw_attribute_error(const sysfs_attribute &attr, int errnum, const char *what) const
+{
+	BOOST_THROW_EXCEPTION(io_error()
+		<< io_error::what_t(what)
+		<< io_error::filename(attr.path())
+		<< io_error::errno_code(errnum));
+}
+
+
+void pwm::keep_open(bool keep_open)
+{
+	m_keep_open = keep_open;
+	if (!keep_open) {
+		for (sysfs_attribute &attr : m_attributes)
+			attr.close();
+	}
+
+	if (m_associated)
+		m_associated->keep_open(keep_open);
+}
+
+
 const char *pwm::make_itempath(const string_ref &item, itempath_buffer_type &dst) const
 {
 	if (item.empty()) {
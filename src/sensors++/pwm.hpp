@@ -10,6 +10,7 @@
 #define SENSORS_PWM_HPP_
 
 #include "internal/common.hpp"
+#include "internal/sysfs_attribute.hpp"
 #include "util/static_allocator/static_string.hpp"
 #include "exceptions.hpp"
 
@@ -116,6 +117,12 @@ public:
 
 	void value(rate_t value);
 
+	/*
+	 * Like value(rate_t), but for the per-tick path: returns 0 or an errno
+	 * value instead of throwing.
+	 */
+	int write(rate_t value);
+
 	void value(item_enum item, value_t value);
 
 	void value(const string_ref &item, value_t value);
@@ -124,6 +131,10 @@ public:
 
 	int number() const;
 
+	bool keep_open() const;
+
+	void keep_open(bool keep_open);
+
 	shared_ptr<const chip_t> chip() const;
 
 	bool operator==(const pwm &other) const;
@@ -141,11 +152,28 @@ protected:
 
 	int m_number;
 
+	bool m_keep_open;
+
+	mutable std::array<sysfs_attribute, Item::_length> m_attributes;
+
 private:
 	value_t value_read(const string_ref &item, bool ignore_value = false) const;
 
+	value_t value_read(item_enum item, bool ignore_value = false) const;
+
 	void value_write(const string_ref &item, value_t value);
 
+	void value_write(item_enum item, value_t value);
+
+	// 0 or an errno value; value may be null to just read
+	int read_item(item_enum item, value_t *value) const;
+
+	int write_item(item_enum item, value_t value);
+
+	sysfs_attribute &attribute(item_enum item) const;
+
+	void throw_attribute_error(const sysfs_attribute &attr, int errnum, const char *what) const;
+
 	bool exists_internal(const string_ref &item, int open_mode) const;
 
 	typedef util::static_string<1 << 8> itempath_buffer_type;
@@ -210,6 +238,13 @@ int pwm::number() const
 }
 
 
+inline
+bool pwm::keep_open() const
+{
+	return m_keep_open;
+}
+
+
 inline
 shared_ptr<const chip> pwm::chip() const
 {
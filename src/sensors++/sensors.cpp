@@ -6,6 +6,7 @@
  */
 
 #include "sensors.hpp"
+#include "internal/hwmon_index.hpp"
 
 #include "util/algorithm.hpp"
 #include <boost/range/algorithm/find_if.hpp>
@@ -62,6 +63,14 @@ const shared_ptr<chip> &sensor_container::chip_internal(
 )
 {
 	if (!chip || !ignore_duplicate_matches) {
+		// a complete name matches at most one chip
+		if (!chip_t::is_wildcard(*match)) {
+			const chip_t::basic_type *const chip_basic = lock::instance()->index().chip(*match);
+			if (chip_basic && (!chip || chip->get() != chip_basic))
+				chip.reset(new chip_t(chip_basic));
+			return chip;
+		}
+
 		int nr = 0;
 		const chip_t::basic_type *const chip_basic = sensors_get_detected_chips(match, &nr);
 		if (chip_basic) {
@@ -112,20 +121,12 @@ shared_ptr<chip> sensor_container::chip(
 	}
 
 	// if necessary, detect the chip; test its uniqueness
-	int nr = 0;
-	BOOST_ASSERT(!name.begin() || !*name.end());
-	const chip_t::basic_type match = {
-			const_cast<char*>(name.c_str()),
-			{ SENSORS_BUS_TYPE_ANY, SENSORS_BUS_NR_ANY },
-			SENSORS_CHIP_NAME_ADDR_ANY, 0
-		},
-		*basic_chip = sensors_get_detected_chips(&match, &nr);
-
-	if (!basic_chip)
+	const hwmon_index &index = m_lock->index();
+	const hwmon_index::chip_list &matches = index.chips(name);
+	if (matches.empty())
 		return shared_ptr<chip_t>();
 
-	BOOST_ASSERT(basic_chip != &match);
-	BOOST_ASSERT(!basic_chip || basic_chip->prefix != name.begin());
+	const chip_t::basic_type *const basic_chip = &index.chip(matches.front());
 
 	if (it_chip == m_chips.end()) {
 		std::pair<map_type::iterator, bool> r =
@@ -134,7 +135,7 @@ shared_ptr<chip> sensor_container::chip(
 		it_chip = r.first;
 	}
 
-	if (!ignore_duplicate_matches && !!sensors_get_detected_chips(&match, &nr))
+	if (!ignore_duplicate_matches && matches.size() > 1)
 		BOOST_THROW_EXCEPTION(sensor_error(sensor_error::misplaced_wildcard));
 
 	return it_chip->second;
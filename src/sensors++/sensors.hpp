@@ -33,7 +33,7 @@ public:
 
 	typedef std::unordered_map<
 			chip_t::basic_type, shared_ptr<chip_t>,
-			boost::hash<chip_t::basic_type>, std::equal_to<chip_t::basic_type>,
+			helper::chip_identity_hash, helper::chip_identity_equal,
 			util::static_allocator<
 				std::pair< const chip_t::basic_type, shared_ptr<chip_t> >, 8
 			>
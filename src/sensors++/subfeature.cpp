@@ -21,17 +21,129 @@
 namespace sensors {
 
 
-double subfeature::value() const
+int subfeature::read_libsensors(double &v) const
 {
 	UTIL_CHECK_POINTER(get());
 	UTIL_CHECK_POINTER(parent());
 	UTIL_CHECK_POINTER(parent()->parent());
 
-	double v;
-	int errnum;
-	if ((errnum = sensors_get_value(parent()->parent()->get(), get()->number, &v)) != 0)
+	double value;
+	const int errnum = sensors_get_value(parent()->parent()->get(), get()->number, &value);
+	if (errnum == 0)
+		v = value;
+	// libsensors reports negative codes already
+	return (errnum > 0) ? -errnum : errnum;
+}
+
+
+int subfeature::read_direct(double &v) const
+{
+	double raw;
+	const int errnum = m_attribute.read(raw);
+	if (errnum == 0)
+		v = scaled(raw);
+	return errnum;
+}
+
+
+void subfeature::throw_read_error(int errnum) const
+{
+	if (errnum < 0)
 		BOOST_THROW_EXCEPTION(sensor_error(errnum));
-	return v;
+
+	BOOST_THROW_EXCEPTION(sensor_error(sensor_error::kernel_interface_error)
+		<< io_error::errno_code(errnum)
+		<< io_error::filename(m_attribute.path()));
+}
+
+
+const char *subfeature::strerror(int errnum)
+{
+	return (errnum < 0) ? sensor_error::strerror(errnum) : std::strerror(errnum);
+}
+
+
+/*
+ * Reads the subfeature's sysfs file directly instead of through
+ * sensors_get_value(). libsensors offers no way to evaluate a compute
+ * statement on its own, so the fast path is only taken, if none applies:
+ * Either the subfeature is not subject to compute mappings at all, or a
+ * probe read yields the same result on both paths.
+ */
+bool subfeature::direct(bool enable)
+{
+	if (!enable) {
+		m_direct = false;
+		m_attribute.close();
+	} else if (!m_direct) {
+		UTIL_CHECK_POINTER(get());
+		const chip &ch = *UTIL_CHECK_POINTER(UTIL_CHECK_POINTER(parent())->parent());
+		std::string path;
+		ch.path().str(path);
+		(path += '/') += get()->name;
+		m_attribute.assign(path, O_RDONLY);
+		m_scaling = scaling(get()->type);
+		m_direct = m_attribute.open() == 0 && probe_direct();
+		if (!m_direct)
+			m_attribute.close();
+	}
+	return m_direct;
+}
+
+
+bool subfeature::probe_direct()
+{
+	if (!test_flag(flags::compute_mapping))
+		return true;
+
+	// A compute statement mapping a probe value onto itself is unlikely,
+	// unless that value is zero (stopped fans). Try a few times in case the
+	// value changes between both reads.
+	for (unsigned i = 0; i < 3; i++) {
+		double raw, expected;
+		if (m_attribute.read(raw) != 0)
+			return false;
+		if (sensors_get_value(parent()->parent()->get(), get()->number, &expected) != 0)
+			return false;
+		if (raw == 0)
+			continue;
+		if (scaled(raw) == expected)
+			return true;
+	}
+	return false;
+}
+
+
+double subfeature::scaling(type_enum type)
+{
+	// mirrors get_type_scaling() of libsensors' sysfs backend
+	switch (type & 0xFF80) {
+		case SENSORS_SUBFEATURE_IN_INPUT:
+		case SENSORS_SUBFEATURE_TEMP_INPUT:
+		case SENSORS_SUBFEATURE_CURR_INPUT:
+		case SENSORS_SUBFEATURE_HUMIDITY_INPUT:
+			return 1e3;
+
+		case SENSORS_SUBFEATURE_FAN_INPUT:
+			return 1;
+
+		case SENSORS_SUBFEATURE_POWER_AVERAGE:
+		case SENSORS_SUBFEATURE_ENERGY_INPUT:
+			return 1e6;
+
+		default:
+			break;
+	}
+
+	switch (type) {
+		case SENSORS_SUBFEATURE_POWER_AVERAGE_INTERVAL:
+		case SENSORS_SUBFEATURE_VID:
+		case SENSORS_SUBFEATURE_TEMP_OFFSET:
+			return 1e3;
+
+		default:
+			return 1;
+	}
 }
 
 
@@ -78,3 +190,4 @@ subfeature::type_enum subfeature::type_from_name(sensors_feature_type feature, c
 
 
 template std::ostream &operator<<(std::ostream&, const sensors::feature&);
+template std::ostream &operator<<(std::ostream&, const sensors::subfeature&);
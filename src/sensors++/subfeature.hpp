@@ -11,6 +11,7 @@
 
 #include "internal/common.hpp"
 #include "internal/object_wrapper.hpp"
+#include "internal/sysfs_attribute.hpp"
 #include "exceptions.hpp"
 #include "csensors.hpp"
 #include "feature.hpp"
@@ -33,6 +34,8 @@ public:
 
 	static type_enum type_from_name(sensors_feature_type feature, const string_ref &name);
 
+	static double scaling(type_enum type);
+
 	struct flags {
 		enum value {
 			readable,
@@ -52,9 +55,42 @@ public:
 
 	double value() const;
 
+	/*
+	 * Like value(), but for the per-tick path: returns 0, a positive errno
+	 * value from a direct read or a negative libsensors error instead of
+	 * throwing, and leaves v alone on failure.
+	 */
+	int read(double &v) const;
+
+	// describes a result of read()
+	static const char *strerror(int errnum);
+
 	void value(double) const;
 
+	bool direct() const;
+
+	bool direct(bool enable);
+
+	const sysfs_attribute &attribute() const;
+
+	double scaled(double raw) const;
+
 	bool operator==(const super &o) const;
+
+private:
+	int read_direct(double &v) const;
+
+	int read_libsensors(double &v) const;
+
+	void throw_read_error(int errnum) const;
+
+	bool probe_direct();
+
+	mutable sysfs_attribute m_attribute;
+
+	double m_scaling;
+
+	bool m_direct;
 };
 
 } /* namespace sensors */
@@ -72,7 +108,48 @@ namespace sensors {
 inline
 subfeature::subfeature(basic_type *subfeature, const shared_ptr<feature> &feature)
 	: object_wrapper_numbered(subfeature, feature)
+	, m_scaling(1)
+	, m_direct(false)
+{
+}
+
+
+inline
+double subfeature::value() const
+{
+	double v;
+	const int errnum = read(v);
+	if (errnum != 0)
+		throw_read_error(errnum);
+	return v;
+}
+
+
+inline
+int subfeature::read(double &v) const
+{
+	return m_direct ? read_direct(v) : read_libsensors(v);
+}
+
+
+inline
+bool subfeature::direct() const
+{
+	return m_direct;
+}
+
+
+inline
+const sysfs_attribute &subfeature::attribute() const
+{
+	return m_attribute;
+}
+
+
+inline
+double subfeature::scaled(double raw) const
 {
+	return raw / m_scaling;
 }
 
 
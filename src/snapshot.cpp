@@ -0,0 +1,273 @@
+/*
+ * snapshot.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "snapshot.hpp"
+#include "sensors++/subfeature.hpp"
+#include "sensors++/feature.hpp"
+#include "sensors++/chip.hpp"
+#include "util/algorithm.hpp"
+#include "util/clock.hpp"
+
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <limits>
+#include <cstring>
+
+
+namespace fancontrol {
+
+namespace {
+
+	const sensors::chip &chip_of(const snapshot::SF &sf)
+	{
+		return *UTIL_CHECK_POINTER(UTIL_CHECK_POINTER(sf.parent())->parent());
+	}
+
+
+	int compare(const snapshot::SF &a, const snapshot::SF &b)
+	{
+		const sensors::chip &chip_a = chip_of(a), &chip_b = chip_of(b);
+		if (&chip_a != &chip_b) {
+			const int c = chip_a.path().compare(chip_b.path());
+			if (c != 0)
+				return c;
+		}
+		return util::compare(a->number, b->number);
+	}
+
+
+	struct source_less {
+		bool operator()(const shared_ptr<const snapshot::SF> &a, const shared_ptr<const snapshot::SF> &b) const {
+			return compare(*a, *b) < 0;
+		}
+
+		bool operator()(const shared_ptr<const snapshot::SF> &a, const snapshot::SF &b) const {
+			return compare(*a, b) < 0;
+		}
+	};
+
+
+	struct source_equal {
+		bool operator()(const shared_ptr<const snapshot::SF> &a, const shared_ptr<const snapshot::SF> &b) const {
+			return *a == *b;
+		}
+	};
+
+}
+
+
+const snapshot::size_type snapshot::npos;
+const unsigned snapshot::max_failed_reads;
+
+
+snapshot::snapshot()
+	: m_failures(0)
+	, m_chip_offsets(1, 0)
+	, m_built(false)
+{
+}
+
+
+void snapshot::add(const shared_ptr<const SF> &source)
+{
+	BOOST_ASSERT(!m_built);
+	BOOST_ASSERT(source);
+	m_sources.push_back(source);
+}
+
+
+void snapshot::build()
+{
+	std::sort(m_sources.begin(), m_sources.end(), source_less());
+	m_sources.erase(
+		std::unique(m_sources.begin(), m_sources.end(), source_equal()),
+		m_sources.end());
+	m_sources.shrink_to_fit();
+	m_values.assign(m_sources.size(), std::numeric_limits<value_t>::quiet_NaN());
+	m_errors.assign(m_sources.size(), 0);
+	m_failed_reads.assign(m_sources.size(), 0);
+	m_failures = 0;
+
+	m_chip_offsets.clear();
+	for (size_type i = 0; i < m_sources.size(); i++) {
+		if (i == 0 || &chip_of(*m_sources[i]) != &chip_of(*m_sources[i-1]))
+			m_chip_offsets.push_back(i);
+	}
+	m_chip_offsets.push_back(m_sources.size());
+	m_chip_durations.assign(chips(), 0);
+	m_built = true;
+}
+
+
+snapshot::size_type snapshot::index(const SF &source) const
+{
+	BOOST_ASSERT(m_built);
+	const sources_container::const_iterator it =
+		std::lower_bound(m_sources.begin(), m_sources.end(), source, source_less());
+	return (it != m_sources.end() && **it == source) ?
+		static_cast<size_type>(it - m_sources.begin()) : npos;
+}
+
+
+std::string snapshot::name(size_type i) const
+{
+	std::ostringstream s;
+	s << *m_sources[i];
+	return s.str();
+}
+
+
+const snapshot::value_t *snapshot::find(const SF &source) const
+{
+	const size_type i = index(source);
+	return (i != npos) ? &m_values[i] : nullptr;
+}
+
+
+void snapshot::sample()
+{
+	BOOST_ASSERT(m_built);
+	m_failures = 0;
+	if (m_uring) {
+		std::fill(m_chip_durations.begin(), m_chip_durations.end(), 0);
+		sample_batch();
+	} else {
+		std::uint64_t start = util::monotonic_ns();
+		for (size_type g = 0; g < chips(); g++) {
+			for (size_type i = m_chip_offsets[g]; i < m_chip_offsets[g+1]; i++)
+				sample_sync(i);
+			const std::uint64_t end = util::monotonic_ns();
+			m_chip_durations[g] = end - start;
+			start = end;
+		}
+	}
+}
+
+
+inline
+void snapshot::sample_sync(size_type i)
+{
+	const int errnum = m_sources[i]->read(m_values[i]);
+	if (errnum != 0 || m_errors[i] != 0)
+		record(i, errnum);
+}
+
+
+/*
+ * Only changes are logged, so a failing source doesn't flood the log. After
+ * max_failed_reads failures in a row, the last value is dropped, so the fans
+ * that depend on it fall back to their reset rate instead of following a
+ * reading that no longer changes.
+ */
+void snapshot::record(size_type i, int errnum)
+{
+	if (errnum != 0) {
+		m_failures++;
+		if (m_failed_reads[i] < max_failed_reads && ++m_failed_reads[i] == max_failed_reads) {
+			m_values[i] = std::numeric_limits<value_t>::quiet_NaN();
+			std::clog << "Couldn't read " << name(i) << ' ' << max_failed_reads
+				<< " times in a row, dropping its last value" << std::endl;
+		}
+	} else {
+		m_failed_reads[i] = 0;
+	}
+
+	if (errnum != m_errors[i]) {
+		if (errnum != 0) {
+			std::clog << "Couldn't read " << name(i) << " (" << SF::strerror(errnum) << "), "
+				"keeping its last value for now" << std::endl;
+		} else {
+			std::clog << "Reading " << name(i) << " again" << std::endl;
+		}
+		m_errors[i] = errnum;
+	}
+}
+
+
+void snapshot::sample_batch()
+{
+	for (size_type i = 0; i < m_requests.size(); i++) {
+		m_requests[i].fd = m_sources[m_request_entries[i]]->attribute().fd();
+	}
+
+	const int errnum = m_uring->read(m_requests.data(), m_requests.data() + m_requests.size());
+	if (errnum != 0) {
+		std::clog << "io_uring sampling failed (" << std::strerror(errnum) << "), "
+			"falling back to synchronous reads" << std::endl;
+		use_io_uring(false);
+		return sample();
+	}
+
+	for (size_type i = 0; i < m_requests.size(); i++) {
+		util::uring_batch::request &r = m_requests[i];
+		const size_type j = m_request_entries[i];
+		double raw;
+		if (r.result > 0 && static_cast<unsigned>(r.result) < r.size) {
+			r.buffer[r.result] = '\0';
+			if (sensors::sysfs_attribute::parse(r.buffer, raw) == 0) {
+				m_values[j] = m_sources[j]->scaled(raw);
+				if (m_errors[j] != 0)
+					record(j, 0);
+				continue;
+			}
+		}
+		// let the synchronous path deal with errors and stale descriptors
+		sample_sync(j);
+	}
+
+	for (const size_type i : m_sync_entries) {
+		sample_sync(i);
+	}
+}
+
+
+bool snapshot::use_io_uring(bool enable)
+{
+	BOOST_ASSERT(m_built);
+	m_uring.reset();
+	m_requests.clear();
+	m_request_entries.clear();
+	m_sync_entries.clear();
+	m_buffers.clear();
+
+	if (!enable || m_sources.empty())
+		return false;
+
+	for (size_type i = 0; i < m_sources.size(); i++) {
+		(m_sources[i]->direct() ? m_request_entries : m_sync_entries).push_back(i);
+	}
+	if (m_request_entries.empty()) {
+		m_sync_entries.clear();
+		return false;
+	}
+
+	std::unique_ptr<util::uring_batch> uring(new util::uring_batch);
+	const int errnum = uring->init(static_cast<unsigned>(m_request_entries.size()));
+	if (errnum != 0) {
+		std::clog << "io_uring is unavailable (" << std::strerror(errnum) << "), "
+			"using synchronous sampling" << std::endl;
+		m_request_entries.clear();
+		m_sync_entries.clear();
+		return false;
+	}
+
+	m_buffers.resize(m_request_entries.size());
+	m_requests.resize(m_request_entries.size());
+	for (size_type i = 0; i < m_requests.size(); i++) {
+		util::uring_batch::request &r = m_requests[i];
+		r.fd = -1;
+		r.buffer = m_buffers[i].data();
+		r.size = static_cast<unsigned>(m_buffers[i].size() - 1);
+		r.result = 0;
+	}
+
+	m_uring = std::move(uring);
+	return true;
+}
+
+} /* namespace fancontrol */
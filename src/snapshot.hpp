@@ -0,0 +1,222 @@
+/*
+ * snapshot.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef FANCONTROL_SNAPSHOT_HPP_
+#define FANCONTROL_SNAPSHOT_HPP_
+
+#include "util/uring_batch.hpp"
+#include "util/memory.hpp"
+#include <vector>
+#include <string>
+#include <array>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace sensors {
+	class subfeature;
+}
+
+namespace fancontrol {
+
+using util::shared_ptr;
+
+
+/*
+ * A flat array of all distinct sensor readings used during one tick.
+ *
+ * Sources are registered while the configuration is assembled; build() then
+ * orders them by chip and removes duplicates. After that, the index and the
+ * slot of each source stay fixed, so controls and fans can bind to it and
+ * read the value sampled for the current tick instead of querying the
+ * hardware themselves. Sources and values are kept in separate arrays, so
+ * the values of one tick are contiguous.
+ *
+ * Optionally, all sources with an open sysfs descriptor are sampled as one
+ * io_uring batch; the others are still read one after another.
+ *
+ * Sampling doesn't throw: a source that can't be read keeps its last value,
+ * which is NaN until it was read once, and its error is remembered. After
+ * max_failed_reads failed reads in a row, its value becomes NaN again.
+ */
+class snapshot
+{
+public:
+	typedef sensors::subfeature SF;
+
+	typedef double value_t;
+
+	typedef std::vector< shared_ptr<const SF> > sources_container;
+	typedef sources_container::size_type size_type;
+
+	static const size_type npos = static_cast<size_type>(-1);
+
+	static const unsigned max_failed_reads = 3;
+
+	snapshot();
+
+	void add(const shared_ptr<const SF> &source);
+
+	void build();
+
+	bool built() const;
+
+	size_type index(const SF &source) const;
+
+	const value_t *find(const SF &source) const;
+
+	void sample();
+
+	bool use_io_uring(bool enable);
+
+	bool uses_io_uring() const;
+
+	size_type size() const;
+
+	bool empty() const;
+
+	const shared_ptr<const SF> &source(size_type i) const;
+
+	// chip, address and subfeature of a source, e.g. "it8728-isa:0a30/temp1_input"
+	std::string name(size_type i) const;
+
+	// Sources are grouped by chip; each group spans [chip_begin(g), chip_begin(g+1)).
+	size_type chips() const;
+
+	size_type chip_begin(size_type group) const;
+
+	/*
+	 * Nanoseconds each chip's sources took to read in the last sample(), if
+	 * it read them one after another; all 0 after an io_uring batch.
+	 */
+	const std::uint64_t *chip_durations() const;
+
+	const value_t *values() const;
+
+	// the result of the last read of a source, see subfeature::read()
+	int error(size_type i) const;
+
+	// sources that couldn't be read in the last sample()
+	size_type failures() const;
+
+private:
+	void sample_sync(size_type i);
+
+	void record(size_type i, int errnum);
+
+	void sample_batch();
+
+	sources_container m_sources;
+
+	std::vector<value_t> m_values;
+
+	std::vector<int> m_errors;
+
+	// consecutive failed reads of each source, up to max_failed_reads
+	std::vector<unsigned> m_failed_reads;
+
+	size_type m_failures;
+
+	// first source of each chip and one past the last source
+	std::vector<size_type> m_chip_offsets;
+
+	std::vector<std::uint64_t> m_chip_durations;
+
+	bool m_built;
+
+	std::unique_ptr<util::uring_batch> m_uring;
+
+	std::vector<util::uring_batch::request> m_requests;
+
+	std::vector<size_type> m_request_entries, m_sync_entries;
+
+	std::vector< std::array<char, 32> > m_buffers;
+};
+
+
+
+// implementation =============================================================
+
+inline
+bool snapshot::built() const
+{
+	return m_built;
+}
+
+
+inline
+bool snapshot::uses_io_uring() const
+{
+	return !!m_uring;
+}
+
+
+inline
+snapshot::size_type snapshot::size() const
+{
+	return m_sources.size();
+}
+
+
+inline
+bool snapshot::empty() const
+{
+	return m_sources.empty();
+}
+
+
+inline
+snapshot::size_type snapshot::chips() const
+{
+	return m_chip_offsets.size() - 1;
+}
+
+
+inline
+snapshot::size_type snapshot::chip_begin(size_type group) const
+{
+	return m_chip_offsets[group];
+}
+
+
+inline
+const std::uint64_t *snapshot::chip_durations() const
+{
+	return m_chip_durations.data();
+}
+
+
+inline
+const shared_ptr<const snapshot::SF> &snapshot::source(size_type i) const
+{
+	return m_sources[i];
+}
+
+
+inline
+const snapshot::value_t *snapshot::values() const
+{
+	return m_values.data();
+}
+
+
+inline
+int snapshot::error(size_type i) const
+{
+	return m_errors[i];
+}
+
+
+inline
+snapshot::size_type snapshot::failures() const
+{
+	return m_failures;
+}
+
+} /* namespace fancontrol */
+#endif /* FANCONTROL_SNAPSHOT_HPP_ */
@@ -0,0 +1,240 @@
+/*
+ * status.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "status.hpp"
+#include "util/exception.hpp"
+
+#include <boost/throw_exception.hpp>
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <cmath>
+#include <ctime>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+namespace fancontrol {
+	namespace status {
+
+using util::io_error;
+using telemetry::channel;
+
+
+namespace {
+
+	void throw_io_error(const char *what, const std::string &path, int errnum = errno)
+	{
+		BOOST_THROW_EXCEPTION(io_error()
+			<< io_error::what_t(what)
+			<< io_error::filename(path)
+			<< io_error::errno_code(errnum));
+	}
+
+}
+
+
+const char segment_header::magic_value[8] = { 'F', 'C', '2', 'S', 'T', 'A', 'T', 0 };
+
+const char default_path[] = "/dev/shm/fancontrol2";
+
+
+bool segment_header::valid() const
+{
+	return std::memcmp(magic, magic_value, sizeof(magic)) == 0
+		&& version == version_value
+		&& header_size == status::header_size(channel_count);
+}
+
+
+std::uint32_t header_size(std::uint32_t channel_count)
+{
+	const std::size_t n = sizeof(segment_header) + channel_count * sizeof(channel);
+	return static_cast<std::uint32_t>((n + 63) / 64 * 64);
+}
+
+
+publisher::publisher()
+	: m_map(nullptr)
+	, m_map_size(0)
+	, m_header(nullptr)
+{
+}
+
+
+publisher::~publisher()
+{
+	close();
+}
+
+
+/*
+ * The segment is prepared under a temporary name and renamed into place, so
+ * a reader opens either the old or the complete new one.
+ */
+void publisher::open(const std::string &path, const channels_container &channels)
+{
+	close();
+
+	const std::uint32_t channel_count = static_cast<std::uint32_t>(channels.size());
+	const std::uint32_t values_offset = header_size(channel_count);
+	const std::size_t size = values_offset + channel_count * sizeof(float);
+
+	// a fresh name, so nothing planted in a shared directory is followed
+	std::string tmp_path(path + ".XXXXXX");
+	const int fd = ::mkostemp(&tmp_path[0], O_CLOEXEC);
+	if (fd < 0)
+		throw_io_error("Couldn't create the status segment", tmp_path);
+	// readable for "fancontrol2 status" run by any user
+	if (::fchmod(fd, 0644) != 0 || ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+		const int errnum = errno;
+		::close(fd);
+		::unlink(tmp_path.c_str());
+		throw_io_error("Couldn't resize the status segment", tmp_path, errnum);
+	}
+
+	void *const map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	const int errnum = errno;
+	::close(fd);
+	if (map == MAP_FAILED) {
+		::unlink(tmp_path.c_str());
+		throw_io_error("Couldn't map the status segment", tmp_path, errnum);
+	}
+
+	m_map = static_cast<unsigned char*>(map);
+	m_map_size = size;
+	m_header = reinterpret_cast<segment_header*>(m_map);
+
+	// The file is new, so everything else is already zero.
+	std::memcpy(m_header->magic, segment_header::magic_value, sizeof(m_header->magic));
+	m_header->version = segment_header::version_value;
+	m_header->channel_count = channel_count;
+	m_header->header_size = values_offset;
+	m_header->pid = static_cast<std::uint32_t>(::getpid());
+	std::copy(channels.begin(), channels.end(), reinterpret_cast<channel*>(m_header + 1));
+	std::fill_n(reinterpret_cast<float*>(m_map + values_offset), channel_count, NAN);
+
+	if (::rename(tmp_path.c_str(), path.c_str()) != 0) {
+		const int errnum = errno;
+		::unlink(tmp_path.c_str());
+		close();
+		throw_io_error("Couldn't publish the status segment", path, errnum);
+	}
+}
+
+
+void publisher::close()
+{
+	if (m_map) {
+		__atomic_store_n(&m_header->pid, 0, __ATOMIC_RELEASE);
+		::munmap(m_map, m_map_size);
+		m_map = nullptr;
+		m_map_size = 0;
+		m_header = nullptr;
+	}
+}
+
+
+float *publisher::begin_update()
+{
+	BOOST_ASSERT(is_open());
+	const std::uint64_t sequence = m_header->sequence;
+	BOOST_ASSERT(sequence % 2 == 0);
+	__atomic_store_n(&m_header->sequence, sequence + 1, __ATOMIC_RELAXED);
+	// orders the odd sequence before the value stores
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	return reinterpret_cast<float*>(m_map + m_header->header_size);
+}
+
+
+void publisher::commit_update(std::uint64_t ticks)
+{
+	BOOST_ASSERT(is_open());
+	BOOST_ASSERT(m_header->sequence % 2 == 1);
+	struct timespec t;
+	::clock_gettime(CLOCK_REALTIME, &t);
+	m_header->time_ns = static_cast<std::int64_t>(t.tv_sec) * 1000000000 + t.tv_nsec;
+	m_header->ticks = ticks;
+	__atomic_store_n(&m_header->sequence, m_header->sequence + 1, __ATOMIC_RELEASE);
+}
+
+
+reader::reader(const std::string &path)
+	: m_map(nullptr)
+	, m_map_size(0)
+	, m_header(nullptr)
+{
+	const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		throw_io_error("Couldn't open the status segment", path);
+
+	struct stat st;
+	void *map = MAP_FAILED;
+	int errnum = EINVAL;
+	if (::fstat(fd, &st) != 0) {
+		errnum = errno;
+	} else if (static_cast<std::size_t>(st.st_size) >= sizeof(segment_header)) {
+		map = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+		errnum = errno;
+	}
+	::close(fd);
+	if (map == MAP_FAILED)
+		throw_io_error("Couldn't map the status segment", path, errnum);
+
+	m_map = static_cast<const unsigned char*>(map);
+	m_map_size = static_cast<std::size_t>(st.st_size);
+	m_header = reinterpret_cast<const segment_header*>(m_map);
+	if (!m_header->valid() ||
+		m_map_size < m_header->header_size + m_header->channel_count * sizeof(float))
+	{
+		::munmap(const_cast<unsigned char*>(m_map), m_map_size);
+		BOOST_THROW_EXCEPTION(std::runtime_error(
+			path + " is no status segment of a supported version"));
+	}
+
+	const channel *const channels = reinterpret_cast<const channel*>(m_header + 1);
+	m_channels.assign(channels, channels + m_header->channel_count);
+}
+
+
+reader::~reader()
+{
+	::munmap(const_cast<unsigned char*>(m_map), m_map_size);
+}
+
+
+bool reader::read(state &s, unsigned attempts) const
+{
+	const float *const values = reinterpret_cast<const float*>(m_map + m_header->header_size);
+	s.values.resize(m_channels.size());
+
+	for (; attempts != 0; attempts--) {
+		const std::uint64_t before = __atomic_load_n(&m_header->sequence, __ATOMIC_ACQUIRE);
+		if (before == 0)
+			return false;
+		if (before % 2 != 0)
+			continue;
+
+		std::copy(values, values + s.values.size(), s.values.begin());
+		s.ticks = m_header->ticks;
+		s.time_ns = m_header->time_ns;
+
+		// orders the copies before the second look at the sequence
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&m_header->sequence, __ATOMIC_RELAXED) == before)
+			return true;
+	}
+	return false;
+}
+
+	} /* namespace status */
+} /* namespace fancontrol */
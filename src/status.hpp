@@ -0,0 +1,163 @@
+/*
+ * status.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef FANCONTROL_STATUS_HPP_
+#define FANCONTROL_STATUS_HPP_
+
+#include "telemetry.hpp"
+
+#include <boost/noncopyable.hpp>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+
+namespace fancontrol {
+	namespace status {
+
+/*
+ * The layout of a status segment: a header and the channel table, padded to
+ * header_size, followed by one float per channel with the state of the
+ * latest tick. The channels are those of a telemetry file.
+ *
+ * The header's sequence is a seqlock: it is odd while the values are being
+ * written and advances by two with every tick, so a reader that sees the same
+ * even sequence before and after copying the values has a consistent state.
+ * Readers never write to the segment, so they can't hold up the daemon.
+ */
+struct segment_header
+{
+	static const char magic_value[8];
+	static const std::uint32_t version_value = 1;
+
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t channel_count;
+	std::uint32_t header_size;
+
+	// of the daemon, or 0 after it closed the segment
+	std::uint32_t pid;
+
+	std::uint64_t sequence;
+
+	// of the latest tick, CLOCK_REALTIME
+	std::int64_t time_ns;
+
+	std::uint64_t ticks;
+
+	bool valid() const;
+};
+
+
+// where the daemon publishes its status unless configured otherwise
+extern const char default_path[];
+
+std::uint32_t header_size(std::uint32_t channel_count);
+
+
+/*
+ * Publishes the state of every tick in a shared memory segment, typically a
+ * file in /dev/shm. A new segment replaces an existing file atomically, so
+ * readers of an old one never see it change size.
+ */
+class publisher
+	: boost::noncopyable
+{
+public:
+	typedef std::vector<telemetry::channel> channels_container;
+
+	publisher();
+
+	~publisher();
+
+	void open(const std::string &path, const channels_container &channels);
+
+	// Marks the segment as abandoned and unmaps it; the file stays.
+	void close();
+
+	bool is_open() const;
+
+	// Returns the values to be overwritten, which readers now ignore.
+	float *begin_update();
+
+	void commit_update(std::uint64_t ticks);
+
+private:
+	unsigned char *m_map;
+
+	std::size_t m_map_size;
+
+	segment_header *m_header;
+};
+
+
+/*
+ * Maps a status segment read-only and copies consistent states out of it.
+ */
+class reader
+	: boost::noncopyable
+{
+public:
+	struct state
+	{
+		std::uint64_t ticks;
+
+		std::int64_t time_ns;
+
+		std::vector<float> values;
+	};
+
+	explicit reader(const std::string &path);
+
+	~reader();
+
+	const std::vector<telemetry::channel> &channels() const;
+
+	// The daemon's PID, or 0 if it closed the segment.
+	std::uint32_t pid() const;
+
+	// False if no consistent state could be read, e.g. before the first tick.
+	bool read(state &s, unsigned attempts = 1000) const;
+
+private:
+	const unsigned char *m_map;
+
+	std::size_t m_map_size;
+
+	const segment_header *m_header;
+
+	std::vector<telemetry::channel> m_channels;
+};
+
+
+
+// implementations ============================================================
+
+inline
+bool publisher::is_open() const
+{
+	return m_map != nullptr;
+}
+
+
+inline
+const std::vector<telemetry::channel> &reader::channels() const
+{
+	return m_channels;
+}
+
+
+inline
+std::uint32_t reader::pid() const
+{
+	return __atomic_load_n(&m_header->pid, __ATOMIC_RELAXED);
+}
+
+	} /* namespace status */
+} /* namespace fancontrol */
+#endif /* FANCONTROL_STATUS_HPP_ */
@@ -0,0 +1,293 @@
+/*
+ * telemetry.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "telemetry.hpp"
+#include "util/exception.hpp"
+
+#include <boost/throw_exception.hpp>
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+namespace fancontrol {
+	namespace telemetry {
+
+using util::io_error;
+
+
+namespace {
+
+	void throw_io_error(const char *what, const std::string &path, int errnum = errno)
+	{
+		BOOST_THROW_EXCEPTION(io_error()
+			<< io_error::what_t(what)
+			<< io_error::filename(path)
+			<< io_error::errno_code(errnum));
+	}
+
+
+	inline std::uint32_t align(std::size_t n, std::size_t alignment)
+	{
+		return static_cast<std::uint32_t>((n + alignment - 1) / alignment * alignment);
+	}
+
+}
+
+
+const char file_header::magic_value[8] = { 'F', 'C', '2', 'T', 'E', 'L', 'E', 0 };
+
+const std::size_t trace::npos;
+
+
+const char *to_string(channel_kind kind)
+{
+	switch (kind) {
+		case sample_channel: return "sample";
+		case rate_channel: return "rate";
+		case rpm_channel: return "rpm";
+		case pwm_channel: return "pwm";
+	}
+	return "unknown";
+}
+
+
+bool file_header::valid() const
+{
+	return std::memcmp(magic, magic_value, sizeof(magic)) == 0
+		&& version == version_value
+		&& header_size == telemetry::header_size(channel_count)
+		&& record_size == telemetry::record_size(channel_count)
+		&& capacity != 0;
+}
+
+
+channel::channel()
+	: kind(0)
+{
+	std::memset(name, 0, sizeof(name));
+}
+
+
+channel::channel(channel_kind kind, const std::string &name)
+	: kind(kind)
+{
+	// a truncated name could match another channel's
+	if (name.size() >= sizeof(this->name)) {
+		BOOST_THROW_EXCEPTION(std::runtime_error(
+			"The telemetry channel name \"" + name + "\" is too long"));
+	}
+	std::memset(this->name, 0, sizeof(this->name));
+	name.copy(this->name, sizeof(this->name) - 1);
+}
+
+
+std::uint32_t header_size(std::uint32_t channel_count)
+{
+	return align(sizeof(file_header) + channel_count * sizeof(channel), 64);
+}
+
+
+std::uint32_t record_size(std::uint32_t channel_count)
+{
+	return align(sizeof(record_header) + channel_count * sizeof(float), alignof(record_header));
+}
+
+
+std::ostream &write_time(std::ostream &out, std::int64_t time_ns)
+{
+	const char fill = out.fill('0');
+	out << time_ns / 1000000000 << '.' << std::setw(3) << (time_ns % 1000000000) / 1000000;
+	out.fill(fill);
+	return out;
+}
+
+
+recorder::recorder()
+	: m_map(nullptr)
+	, m_map_size(0)
+	, m_header(nullptr)
+	, m_records(nullptr)
+	, m_current(nullptr)
+{
+}
+
+
+recorder::~recorder()
+{
+	close();
+}
+
+
+void recorder::open(const std::string &path, std::uint64_t capacity,
+	const channels_container &channels)
+{
+	BOOST_ASSERT(capacity != 0);
+	close();
+
+	// trace::find() tells channels apart by kind and name only
+	for (channels_container::const_iterator c = channels.begin(); c != channels.end(); ++c) {
+		for (channels_container::const_iterator d = channels.begin(); d != c; ++d) {
+			if (d->kind == c->kind && std::strcmp(d->name, c->name) == 0) {
+				BOOST_THROW_EXCEPTION(std::runtime_error(
+					std::string("Duplicate telemetry channel \"") + c->name + "\" of kind " +
+					to_string(static_cast<channel_kind>(c->kind))));
+			}
+		}
+	}
+
+	file_header expected;
+	std::memcpy(expected.magic, file_header::magic_value, sizeof(expected.magic));
+	expected.version = file_header::version_value;
+	expected.channel_count = static_cast<std::uint32_t>(channels.size());
+	expected.header_size = header_size(expected.channel_count);
+	expected.record_size = record_size(expected.channel_count);
+	expected.capacity = capacity;
+	expected.written = 0;
+	const std::size_t size = expected.header_size + capacity * expected.record_size;
+
+	const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if (fd < 0)
+		throw_io_error("Couldn't open the telemetry file", path);
+
+	struct stat st;
+	const bool resume = ::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) == size;
+	if (!resume) {
+		// Truncating first zeroes every slot that survives the resize.
+		if (::ftruncate(fd, 0) != 0 || ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+			const int errnum = errno;
+			::close(fd);
+			throw_io_error("Couldn't resize the telemetry file", path, errnum);
+		}
+	}
+
+	void *const map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	const int errnum = errno;
+	::close(fd);
+	if (map == MAP_FAILED)
+		throw_io_error("Couldn't map the telemetry file", path, errnum);
+
+	m_map = static_cast<unsigned char*>(map);
+	m_map_size = size;
+	m_header = reinterpret_cast<file_header*>(m_map);
+	m_records = m_map + expected.header_size;
+
+	if (!resume || !matches(expected, channels)) {
+		std::memset(m_map, 0, size);
+		*m_header = expected;
+		std::copy(channels.begin(), channels.end(), reinterpret_cast<channel*>(m_header + 1));
+	}
+}
+
+
+bool recorder::matches(const file_header &expected, const channels_container &channels) const
+{
+	return m_header->valid()
+		&& m_header->channel_count == expected.channel_count
+		&& m_header->capacity == expected.capacity
+		&& std::memcmp(m_header + 1, channels.data(), channels.size() * sizeof(channel)) == 0;
+}
+
+
+void recorder::close()
+{
+	if (m_map) {
+		::munmap(m_map, m_map_size);
+		m_map = nullptr;
+		m_map_size = 0;
+		m_header = nullptr;
+		m_records = nullptr;
+		m_current = nullptr;
+	}
+}
+
+
+/*
+ * The sequence number of the slot is cleared before its values change and
+ * set again once they are complete, so a concurrent reader skips records
+ * that are being overwritten.
+ */
+float *recorder::begin_record()
+{
+	BOOST_ASSERT(is_open());
+	const std::uint64_t slot = m_header->written % m_header->capacity;
+	m_current = reinterpret_cast<record_header*>(m_records + slot * m_header->record_size);
+	__atomic_store_n(&m_current->sequence, 0, __ATOMIC_RELAXED);
+	// orders the cleared sequence before the value stores
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	struct timespec t;
+	::clock_gettime(CLOCK_REALTIME, &t);
+	m_current->time_ns = static_cast<std::int64_t>(t.tv_sec) * 1000000000 + t.tv_nsec;
+	return reinterpret_cast<float*>(m_current + 1);
+}
+
+
+void recorder::commit_record()
+{
+	BOOST_ASSERT(m_current != nullptr);
+	const std::uint64_t sequence = m_header->written + 1;
+	__atomic_store_n(&m_current->sequence, sequence, __ATOMIC_RELEASE);
+	__atomic_store_n(&m_header->written, sequence, __ATOMIC_RELEASE);
+	m_current = nullptr;
+}
+
+
+trace::trace(const std::string &path)
+{
+	std::ifstream in(path.c_str(), std::ios::binary);
+	if (!in.read(reinterpret_cast<char*>(&m_header), sizeof(m_header)))
+		throw_io_error("Couldn't read the telemetry file", path);
+	if (!m_header.valid()) {
+		BOOST_THROW_EXCEPTION(std::runtime_error(
+			path + " is no telemetry file of a supported version"));
+	}
+
+	m_channels.resize(m_header.channel_count);
+	in.read(reinterpret_cast<char*>(m_channels.data()),
+		static_cast<std::streamsize>(m_channels.size() * sizeof(channel)));
+
+	std::vector<unsigned char> ring(m_header.capacity * m_header.record_size);
+	in.seekg(m_header.header_size);
+	if (!in.read(reinterpret_cast<char*>(ring.data()), static_cast<std::streamsize>(ring.size())))
+		throw_io_error("Couldn't read the telemetry file", path);
+
+	// The ring starts after the newest record once it wrapped around.
+	const std::uint64_t count = std::min(m_header.written, m_header.capacity);
+	const std::uint64_t first = (m_header.written > m_header.capacity) ?
+		m_header.written % m_header.capacity : 0;
+	m_records.reserve(count * m_header.record_size);
+	for (std::uint64_t i = 0; i < count; i++) {
+		const unsigned char *const r = &ring[(first + i) % m_header.capacity * m_header.record_size];
+		if (reinterpret_cast<const record_header*>(r)->sequence != 0)  // not being written
+			m_records.insert(m_records.end(), r, r + m_header.record_size);
+	}
+}
+
+
+std::size_t trace::find(channel_kind kind, const std::string &name) const
+{
+	for (std::size_t i = 0; i < m_channels.size(); i++) {
+		const channel &c = m_channels[i];
+		if (c.kind == kind && name.size() < sizeof(c.name)
+				&& name.compare(0, name.npos, c.name, ::strnlen(c.name, sizeof(c.name))) == 0)
+			return i;
+	}
+	return npos;
+}
+
+	} /* namespace telemetry */
+} /* namespace fancontrol */
@@ -0,0 +1,231 @@
+/*
+ * telemetry.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef FANCONTROL_TELEMETRY_HPP_
+#define FANCONTROL_TELEMETRY_HPP_
+
+#include <boost/noncopyable.hpp>
+#include <vector>
+#include <string>
+#include <iosfwd>
+#include <cstdint>
+#include <cstddef>
+
+
+namespace fancontrol {
+	namespace telemetry {
+
+/*
+ * The layout of a telemetry file: a header and the channel table, padded to
+ * header_size, followed by a ring of capacity records of record_size bytes.
+ * Every record starts with a record_header and holds one float per channel.
+ * Record n (counting from 1) lives in slot (n - 1) % capacity; a slot whose
+ * sequence is 0 is empty or was being written.
+ *
+ * All fields are in host byte order; the file is meant to be read on the
+ * machine that wrote it.
+ */
+enum channel_kind : std::uint32_t {
+	sample_channel = 1,  // raw sensor reading
+	rate_channel = 2,    // control rate in [0, 1]
+	rpm_channel = 3,     // fan speed
+	pwm_channel = 4,     // raw value written to a PWM, or NaN
+};
+
+const char *to_string(channel_kind kind);
+
+
+struct file_header
+{
+	static const char magic_value[8];
+	static const std::uint32_t version_value = 1;
+
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t channel_count;
+	std::uint32_t header_size;
+	std::uint32_t record_size;
+	std::uint64_t capacity;
+
+	// records committed since the file was initialised
+	std::uint64_t written;
+
+	bool valid() const;
+};
+
+
+struct channel
+{
+	std::uint32_t kind;
+	char name[60];
+
+	channel();
+
+	// throws std::runtime_error if the name doesn't fit
+	channel(channel_kind kind, const std::string &name);
+};
+
+
+struct record_header
+{
+	std::uint64_t sequence;
+
+	// CLOCK_REALTIME
+	std::int64_t time_ns;
+};
+
+
+std::uint32_t header_size(std::uint32_t channel_count);
+
+std::uint32_t record_size(std::uint32_t channel_count);
+
+// seconds since the epoch with milliseconds
+std::ostream &write_time(std::ostream &out, std::int64_t time_ns);
+
+
+/*
+ * Appends records to a memory-mapped telemetry file. An existing file with
+ * the same channel layout and capacity is continued, anything else is
+ * overwritten. Recording touches only the mapping: no allocation and no
+ * system call besides clock_gettime(). Channels must differ in kind or name.
+ */
+class recorder
+	: boost::noncopyable
+{
+public:
+	typedef std::vector<channel> channels_container;
+
+	recorder();
+
+	~recorder();
+
+	void open(const std::string &path, std::uint64_t capacity,
+		const channels_container &channels);
+
+	void close();
+
+	bool is_open() const;
+
+	std::size_t channel_count() const;
+
+	// Returns the values of the next record to be filled in.
+	float *begin_record();
+
+	void commit_record();
+
+	const file_header *header() const;
+
+private:
+	bool matches(const file_header &expected, const channels_container &channels) const;
+
+	unsigned char *m_map;
+
+	std::size_t m_map_size;
+
+	file_header *m_header;
+
+	unsigned char *m_records;
+
+	record_header *m_current;
+};
+
+
+
+/*
+ * A telemetry file read into memory with its complete records in the order
+ * they were written, oldest first.
+ */
+class trace
+{
+public:
+	static const std::size_t npos = static_cast<std::size_t>(-1);
+
+	explicit trace(const std::string &path);
+
+	const file_header &header() const;
+
+	const std::vector<channel> &channels() const;
+
+	// index of the named channel of that kind, or npos
+	std::size_t find(channel_kind kind, const std::string &name) const;
+
+	std::size_t size() const;
+
+	const record_header &record(std::size_t i) const;
+
+	const float *values(std::size_t i) const;
+
+private:
+	file_header m_header;
+
+	std::vector<channel> m_channels;
+
+	std::vector<unsigned char> m_records;
+};
+
+
+
+// implementations ============================================================
+
+inline
+bool recorder::is_open() const
+{
+	return m_map != nullptr;
+}
+
+
+inline
+std::size_t recorder::channel_count() const
+{
+	return m_header->channel_count;
+}
+
+
+inline
+const file_header *recorder::header() const
+{
+	return m_header;
+}
+
+
+inline
+const file_header &trace::header() const
+{
+	return m_header;
+}
+
+
+inline
+const std::vector<channel> &trace::channels() const
+{
+	return m_channels;
+}
+
+
+inline
+std::size_t trace::size() const
+{
+	return m_records.size() / m_header.record_size;
+}
+
+
+inline
+const record_header &trace::record(std::size_t i) const
+{
+	return *reinterpret_cast<const record_header*>(&m_records[i * m_header.record_size]);
+}
+
+
+inline
+const float *trace::values(std::size_t i) const
+{
+	return reinterpret_cast<const float*>(&record(i) + 1);
+}
+
+	} /* namespace telemetry */
+} /* namespace fancontrol */
+#endif /* FANCONTROL_TELEMETRY_HPP_ */
@@ -0,0 +1,58 @@
+/*
+ * tick_timings.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "tick_timings.hpp"
+#include "snapshot.hpp"
+
+#include <ostream>
+
+
+namespace fancontrol {
+
+void tick_timings::setup(const snapshot &samples, const std::vector<std::string> &fan_names)
+{
+	chips.assign(samples.chips(), histogram());
+	chip_names.clear();
+	for (snapshot::size_type g = 0; g < samples.chips(); g++) {
+		const std::string name(samples.name(samples.chip_begin(g)));
+		chip_names.push_back(name.substr(0, name.rfind('/')));
+	}
+
+	fans.assign(fan_names.size(), histogram());
+	this->fan_names = fan_names;
+}
+
+
+void tick_timings::reset()
+{
+	tick.reset();
+	sample.reset();
+	evaluate.reset();
+	commit.reset();
+	jitter.reset();
+	for (histogram &h : chips)
+		h.reset();
+	for (histogram &h : fans)
+		h.reset();
+}
+
+
+std::ostream &operator<<(std::ostream &out, const tick_timings &t)
+{
+	out << "Tick latencies in microseconds:\n"
+		"  tick      " << t.tick << "\n"
+		"  sample    " << t.sample << "\n"
+		"  evaluate  " << t.evaluate << "\n"
+		"  commit    " << t.commit << "\n"
+		"  jitter    " << t.jitter << '\n';
+	for (std::size_t i = 0; i < t.chips.size(); i++)
+		out << "  chip " << t.chip_names[i] << "  " << t.chips[i] << '\n';
+	for (std::size_t i = 0; i < t.fans.size(); i++)
+		out << "  fan " << t.fan_names[i] << "  " << t.fans[i] << '\n';
+	return out;
+}
+
+} /* namespace fancontrol */
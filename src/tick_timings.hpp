@@ -0,0 +1,47 @@
+/*
+ * tick_timings.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef FANCONTROL_TICK_TIMINGS_HPP_
+#define FANCONTROL_TICK_TIMINGS_HPP_
+
+#include "util/histogram.hpp"
+#include <vector>
+#include <string>
+#include <iosfwd>
+
+
+namespace fancontrol {
+
+class snapshot;
+
+
+/*
+ * Latency histograms of the ticks of a configuration: the whole tick and
+ * its phases, the reads of every chip and the PWM writes of every fan. The main loop adds the deviation of the tick period from the
+ * interval, which shows jitter. All are in nanoseconds.
+ */
+struct tick_timings
+{
+	typedef util::histogram histogram;
+
+	histogram tick, sample, evaluate, commit, jitter;
+
+	std::vector<histogram> chips, fans;
+
+	std::vector<std::string> chip_names, fan_names;
+
+	// Sizes the per-chip and per-fan histograms.
+	void setup(const snapshot &samples, const std::vector<std::string> &fan_names);
+
+	void reset();
+};
+
+
+std::ostream &operator<<(std::ostream &out, const tick_timings &t);
+
+} /* namespace fancontrol */
+#endif /* FANCONTROL_TICK_TIMINGS_HPP_ */
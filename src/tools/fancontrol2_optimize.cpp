@@ -0,0 +1,125 @@
+/*
+ * fancontrol2_optimize.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+/*
+ * fancontrol2-optimize: searches the source bounds and fan start and stop
+ * rates of a configuration against a recorded telemetry trace and a thermal
+ * model (see optimizer.hpp) and prints the best configuration as YAML.
+ *
+ * The configuration is parsed like with fancontrol2 --check, so its chips
+ * must be present; nothing is read from the sensors or written to the PWMs.
+ */
+
+#include "optimizer.hpp"
+#include "../config.hpp"
+#include "../sensors++/sensors.hpp"
+
+#include <boost/exception/diagnostic_information.hpp>
+#include <yaml-cpp/yaml.h>
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <unistd.h>
+
+
+namespace {
+
+void usage(const char *argv0, std::ostream &out)
+{
+	out << "Usage: " << argv0 << " [-m MODEL] [-j THREADS] [-r ROUNDS] [-n CANDIDATES]"
+			" [-s SEED] [-o OUTPUT] TRACE CONFIG\n"
+		"\n"
+		"Searches the configuration CONFIG for the lowest mean PWM that keeps the\n"
+		"telemetry TRACE within the ceilings of the thermal MODEL, with ROUNDS (8)\n"
+		"rounds of CANDIDATES (256) candidates each on THREADS (all) threads, and\n"
+		"writes the result to OUTPUT or standard output.\n";
+}
+
+}
+
+
+int main(int argc, char *argv[])
+{
+	using namespace fancontrol;
+	optimize::search_options opt;
+	const char *model_path = nullptr, *output = nullptr;
+
+	int o;
+	while ((o = ::getopt(argc, argv, "m:j:r:n:s:o:h")) != -1) {
+		switch (o) {
+		case 'm': model_path = optarg; break;
+		case 'j': opt.threads = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10)); break;
+		case 'r': opt.rounds = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10)); break;
+		case 'n': opt.candidates = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10)); break;
+		case 's': opt.seed = static_cast<std::uint32_t>(std::strtoul(optarg, nullptr, 10)); break;
+		case 'o': output = optarg; break;
+		case 'h':
+			usage(argv[0], std::cout);
+			return EXIT_SUCCESS;
+		default:
+			usage(argv[0], std::cerr);
+			return EXIT_FAILURE;
+		}
+	}
+	if (optind + 2 != argc || opt.candidates == 0) {
+		usage(argv[0], std::cerr);
+		return EXIT_FAILURE;
+	}
+	const char *const trace_path = argv[optind], *const config_path = argv[optind + 1];
+
+	try {
+		optimize::thermal_model model;
+		if (model_path) {
+			std::ifstream in(model_path);
+			if (!in) {
+				std::cerr << "Couldn't open " << model_path << std::endl;
+				return EXIT_FAILURE;
+			}
+			model.load(in);
+		}
+
+		std::ifstream config_file(config_path);
+		if (!config_file) {
+			std::cerr << "Couldn't open " << config_path << std::endl;
+			return EXIT_FAILURE;
+		}
+		config cfg(config_file, util::make_shared<sensors::sensor_container>(), true);
+		cfg.auto_reset = false;
+
+		const telemetry::trace trace(trace_path);
+		const optimize::optimizer optimizer(cfg, trace, model);
+		const optimize::score initial = optimizer.evaluate(optimizer.initial());
+		optimize::score best;
+		const optimize::parameters result = optimizer.search(opt, best);
+
+		std::clog << "Mean PWM " << initial.mean_pwm << " -> " << best.mean_pwm
+			<< ", worst excess temperature " << initial.excess << " -> " << best.excess
+			<< " over " << trace.size() << " ticks" << std::endl;
+		if (!best.feasible())
+			std::clog << "Warning: no candidate stays within the ceilings" << std::endl;
+
+		YAML::Node doc = YAML::LoadFile(config_path);
+		optimizer.apply(cfg, result, doc);
+		if (output) {
+			std::ofstream out(output);
+			out << doc << std::endl;
+			if (!out) {
+				std::cerr << "Couldn't write " << output << std::endl;
+				return EXIT_FAILURE;
+			}
+		} else {
+			std::cout << doc << std::endl;
+		}
+
+	} catch (boost::exception &e) {
+		std::cerr << boost::diagnostic_information(e) << std::endl;
+		return EXIT_FAILURE;
+	} catch (std::exception &e) {
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,360 @@
+/*
+ * optimizer.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "optimizer.hpp"
+#include "../config.hpp"
+#include "../fan.hpp"
+#include "../sensors++/subfeature.hpp"
+#include "../sensors++/pwm.hpp"
+#include "../util/yaml.hpp"
+
+#include <boost/throw_exception.hpp>
+#include <boost/assert.hpp>
+#include <yaml-cpp/yaml.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <limits>
+#include <cstdlib>
+#include <cmath>
+
+
+namespace fancontrol {
+	namespace optimize {
+
+typedef control_plan::value_t value_t;
+
+
+namespace {
+
+	// decimals of temperature bounds and fan rates in the emitted configuration
+	const int bound_decimals = 1, rate_decimals = 3;
+
+
+	std::string format(value_t value, int decimals)
+	{
+		std::ostringstream s;
+		s << std::fixed << std::setprecision(decimals) << value;
+		return s.str();
+	}
+
+
+	// Rounds like the value will be written and read back.
+	value_t quantize(double value, int decimals)
+	{
+		return std::strtof(format(static_cast<value_t>(value), decimals).c_str(), nullptr);
+	}
+
+
+	value_t clamp_rate(double value)
+	{
+		return quantize(std::min(std::max(value, 0.), 1.), rate_decimals);
+	}
+
+
+	// whether an optional key is set, rather than left out or ~
+	bool is_given(const YAML::Node &node)
+	{
+		return node.IsDefined() && !node.IsNull();
+	}
+
+
+	void parse_zone(const YAML::Node &node, zone_model &zone)
+	{
+		const YAML::Node &gain = node["gain"], &tau = node["tau"], &ceiling = node["ceiling"];
+		if (is_given(gain)) gain >> zone.gain;
+		if (is_given(tau)) tau >> zone.tau;
+		if (is_given(ceiling)) ceiling >> zone.ceiling;
+		if (!(zone.tau > 0))
+			BOOST_THROW_EXCEPTION(std::invalid_argument("A zone's time constant must be positive"));
+	}
+
+}
+
+
+zone_model::zone_model()
+	: gain(20)
+	, tau(60)
+	, ceiling(80)
+{
+}
+
+
+void thermal_model::load(std::istream &in)
+{
+	const YAML::Node doc = YAML::Load(in);
+	const YAML::Node &defaults_node = doc["default"];
+	if (is_given(defaults_node))
+		parse_zone(defaults_node, defaults);
+
+	const YAML::Node &zones_node = doc["zones"];
+	for (YAML::const_iterator it = zones_node.begin(); it != zones_node.end(); ++it) {
+		std::string name;
+		it->first >> name;
+		zone_model zone(defaults);
+		parse_zone(it->second, zone);
+		zones[name] = zone;
+	}
+}
+
+
+const zone_model &thermal_model::zone(const std::string &name) const
+{
+	const std::unordered_map<std::string, zone_model>::const_iterator it = zones.find(name);
+	return (it != zones.end()) ? it->second : defaults;
+}
+
+
+bool score::feasible() const
+{
+	return excess <= 0;
+}
+
+
+bool score::operator<(const score &o) const
+{
+	if (feasible() != o.feasible())
+		return feasible();
+	return feasible() ? mean_pwm < o.mean_pwm : excess < o.excess;
+}
+
+
+search_options::search_options()
+	: threads(0)
+	, rounds(8)
+	, candidates(256)
+	, seed(1)
+{
+}
+
+
+optimizer::optimizer(const config &cfg, const telemetry::trace &trace, const thermal_model &model)
+	: m_trace(trace)
+	, m_plan(cfg.plan)
+	, m_interval(cfg.interval())
+	, m_source_of_sample(cfg.samples.size(), telemetry::trace::npos)
+{
+	const snapshot &samples = cfg.samples;
+	for (snapshot::size_type i = 0; i < samples.size(); i++) {
+		const std::string name(samples.name(i));
+		const std::size_t column = trace.find(telemetry::sample_channel, name);
+		if (column == telemetry::trace::npos) {
+			BOOST_THROW_EXCEPTION(std::invalid_argument(
+				"The trace has no readings of " + name));
+		}
+		m_columns.push_back(column);
+	}
+
+	const std::size_t sources = m_plan.sources();
+	m_zone_fans.resize(sources);
+	for (std::size_t s = 0; s < sources; s++) {
+		m_zones.push_back(model.zone(samples.name(m_plan.sample(s))));
+		m_source_of_sample[m_plan.sample(s)] = s;
+		m_initial.lower.push_back(m_plan.lower_bound(s));
+		m_initial.upper.push_back(m_plan.upper_bound(s));
+	}
+
+	for (config::fans_container::size_type k = 0; k < cfg.fans.size(); k++) {
+		const fan &f = *cfg.fans[k];
+		const control_plan::index_type node = cfg.fan_node(k);
+		m_fan_nodes.push_back(node);
+		m_gauges.push_back(samples.index(*f.m_gauge.get()));
+		m_pwm_columns.push_back(trace.find(telemetry::pwm_channel, *f.m_label + "/pwm"));
+		m_initial.start.push_back(f.m_min_start);
+		m_initial.stop.push_back(f.m_max_stop);
+
+		if (node != control_plan::npos) {
+			std::vector<bool> reached;
+			m_plan.collect_sources(node, reached);
+			for (std::size_t s = 0; s < reached.size(); s++) {
+				if (reached[s])
+					m_zone_fans[s].push_back(k);
+			}
+		}
+	}
+}
+
+
+parameters optimizer::initial() const
+{
+	return m_initial;
+}
+
+
+/*
+ * Each tick, the zones are offset from their recorded readings by the
+ * modelled heat, the plan and fans decide as in the daemon, and the offsets
+ * follow the deficit of the new PWM values against the recorded ones.
+ */
+score optimizer::evaluate(const parameters &p) const
+{
+	control_plan plan(m_plan);
+	const std::size_t sources = plan.sources(), fans = m_fan_nodes.size();
+	for (std::size_t s = 0; s < sources; s++)
+		plan.bounds(s, p.lower[s], p.upper[s]);
+
+	const value_t pwm_max_inverse = sensors::pwm::pwm_max_inverse();
+	std::vector<double> samples(m_columns.size()), offsets(sources, 0.);
+	std::vector<value_t> last(fans, std::numeric_limits<value_t>::quiet_NaN());
+	double pwm_sum = 0, excess = 0;
+	unsigned long pwm_count = 0;
+	std::int64_t last_time = 0;
+
+	for (std::size_t i = 0; i < m_trace.size(); i++) {
+		const float *const values = m_trace.values(i);
+		for (std::size_t k = 0; k < m_columns.size(); k++)
+			samples[k] = values[m_columns[k]];
+		for (std::size_t s = 0; s < sources; s++) {
+			const std::size_t k = plan.sample(s);
+			const double recorded = samples[k];
+			samples[k] += offsets[s];
+			excess = std::max(excess, samples[k] - std::max(m_zones[s].ceiling, recorded));
+		}
+		plan.evaluate(samples.data());
+
+		for (std::size_t k = 0; k < fans; k++) {
+			if (m_fan_nodes[k] == control_plan::npos)
+				continue;
+			// the simulated fan turns whenever it was last driven
+			const double gauge = std::isnan(last[k]) ? samples[m_gauges[k]] : last[k];
+			const value_t value = fan::effective_value(
+				plan.rate(m_fan_nodes[k]), gauge, p.start[k], p.stop[k]);
+			if (fan::needs_update(value, last[k]))
+				last[k] = value;
+			pwm_sum += last[k];
+			pwm_count++;
+		}
+
+		const std::int64_t time = m_trace.record(i).time_ns;
+		const double dt = (i != 0 && time > last_time) ?
+			static_cast<double>(time - last_time) * 1e-9 : m_interval;
+		last_time = time;
+		for (std::size_t s = 0; s < sources; s++) {
+			const std::vector<std::size_t> &zone_fans = m_zone_fans[s];
+			if (zone_fans.empty())
+				continue;
+			double deficit = 0;
+			for (const std::size_t k : zone_fans) {
+				const std::size_t column = m_pwm_columns[k];
+				const float recorded = (column != telemetry::trace::npos) ? values[column] : NAN;
+				if (!std::isnan(recorded))
+					deficit += recorded * pwm_max_inverse - last[k];
+			}
+			deficit /= static_cast<double>(zone_fans.size());
+			const zone_model &zone = m_zones[s];
+			offsets[s] += (zone.gain * deficit - offsets[s]) * (1 - std::exp(-dt / zone.tau));
+		}
+	}
+
+	score r;
+	r.mean_pwm = pwm_count ? pwm_sum / static_cast<double>(pwm_count) : 0;
+	r.excess = excess;
+	return r;
+}
+
+
+parameters optimizer::perturb(const parameters &p, double scale, std::uint32_t round,
+	std::uint32_t candidate, std::uint32_t seed) const
+{
+	std::seed_seq seq{ seed, round, candidate };
+	std::mt19937 rng(seq);
+	std::normal_distribution<double> normal;
+	parameters c(p);
+
+	for (std::size_t s = 0; s < c.lower.size(); s++) {
+		const double step = 0.5 * scale * std::max<double>(p.upper[s] - p.lower[s], 5);
+		c.lower[s] = quantize(p.lower[s] + step * normal(rng), bound_decimals);
+		c.upper[s] = quantize(p.upper[s] + step * normal(rng), bound_decimals);
+		// at least one degree apart, so the rate stays defined
+		if (c.upper[s] < c.lower[s] + 1)
+			c.upper[s] = quantize(c.lower[s] + 1., bound_decimals);
+	}
+
+	for (std::size_t k = 0; k < c.start.size(); k++) {
+		const double step = 0.25 * scale;
+		c.start[k] = clamp_rate(p.start[k] + step * normal(rng));
+		c.stop[k] = std::min(clamp_rate(p.stop[k] + step * normal(rng)), c.start[k]);
+	}
+	return c;
+}
+
+
+parameters optimizer::search(const search_options &opt, score &best) const
+{
+	const unsigned threads = opt.threads ? opt.threads :
+		std::max(std::thread::hardware_concurrency(), 1u);
+	parameters best_params(m_initial);
+	best = evaluate(best_params);
+
+	std::vector<parameters> candidates(opt.candidates);
+	std::vector<score> scores(opt.candidates);
+	for (std::uint32_t round = 0; round < opt.rounds; round++) {
+		const double scale = std::ldexp(1., -static_cast<int>(round));
+		for (std::uint32_t i = 0; i < opt.candidates; i++)
+			candidates[i] = perturb(best_params, scale, round, i, opt.seed);
+
+		std::atomic<std::size_t> next(0);
+		const auto work = [this, &next, &candidates, &scores]() {
+			for (std::size_t i; (i = next++) < candidates.size(); )
+				scores[i] = evaluate(candidates[i]);
+		};
+		std::vector<std::thread> workers;
+		for (unsigned t = 1; t < threads; t++)
+			workers.emplace_back(work);
+		work();
+		for (std::thread &t : workers)
+			t.join();
+
+		const std::size_t winner = static_cast<std::size_t>(
+			std::min_element(scores.begin(), scores.end()) - scores.begin());
+		if (winner < scores.size() && scores[winner] < best) {
+			best = scores[winner];
+			best_params = candidates[winner];
+		}
+	}
+	return best_params;
+}
+
+
+/*
+ * Fans are matched by their order in the document and bounded sources by
+ * the sample they resolve to, so every node of a shared source gets the
+ * same bounds.
+ */
+void optimizer::apply(config &cfg, const parameters &p, YAML::Node &doc) const
+{
+	YAML::Node fans = doc["fans"];
+	std::size_t k = 0;
+	for (YAML::iterator it = fans.begin(); it != fans.end(); ++it, ++k) {
+		YAML::Node node = it->second;
+		node["start"] = format(p.start[k], rate_decimals);
+		node["stop"] = format(p.stop[k], rate_decimals);
+		apply_dependencies(cfg, p, node["dependencies"]);
+	}
+	BOOST_ASSERT(k == p.start.size());
+}
+
+
+void optimizer::apply_dependencies(config &cfg, const parameters &p, YAML::Node node) const
+{
+	if (node.Type() == YAML::NodeType::Sequence) {
+		for (YAML::iterator it = node.begin(); it != node.end(); ++it)
+			apply_dependencies(cfg, p, *it);
+	} else if (node.Type() == YAML::NodeType::Map) {
+		const std::size_t sample = cfg.samples.index(*cfg.parse_subfeature(node["source"]));
+		const std::size_t s = m_source_of_sample[sample];
+		BOOST_ASSERT(s != telemetry::trace::npos);
+		node["min"] = format(p.lower[s], bound_decimals);
+		node["max"] = format(p.upper[s], bound_decimals);
+	}
+}
+
+	} /* namespace optimize */
+} /* namespace fancontrol */
@@ -0,0 +1,174 @@
+/*
+ * optimizer.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef FANCONTROL_OPTIMIZER_HPP_
+#define FANCONTROL_OPTIMIZER_HPP_
+
+#include "../control_plan.hpp"
+#include "../telemetry.hpp"
+
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <iosfwd>
+#include <cstdint>
+
+
+namespace YAML {
+	class Node;
+}
+
+
+namespace fancontrol {
+
+class config;
+
+	namespace optimize {
+
+/*
+ * How a temperature zone reacts to running its fans slower than recorded:
+ * the temperature approaches gain times the PWM deficit above the recording
+ * with the time constant tau. A zone must not get hotter than its ceiling,
+ * or than it was recorded if that was hotter already.
+ */
+struct zone_model
+{
+	zone_model();
+
+	// degrees Celsius at a PWM deficit of 1
+	double gain;
+
+	// seconds
+	double tau;
+
+	// degrees Celsius
+	double ceiling;
+};
+
+
+/*
+ * Zones are named like the sample channels of a telemetry trace:
+ *
+ *   default:
+ *       gain: 20
+ *       tau: 60
+ *       ceiling: 80
+ *   zones:
+ *       "coretemp-isa:0000/temp2_input":
+ *           ceiling: 85
+ */
+struct thermal_model
+{
+	zone_model defaults;
+
+	std::unordered_map<std::string, zone_model> zones;
+
+	void load(std::istream &in);
+
+	const zone_model &zone(const std::string &name) const;
+};
+
+
+// bounds of every plan source and start and stop rates of every fan
+struct parameters
+{
+	std::vector<control_plan::value_t> lower, upper, start, stop;
+};
+
+
+struct score
+{
+	// over all ticks and fans with a control
+	double mean_pwm;
+
+	// degrees Celsius above the allowed temperature at worst
+	double excess;
+
+	bool feasible() const;
+
+	// feasible before infeasible, then the quieter or less hot
+	bool operator<(const score &o) const;
+};
+
+
+struct search_options
+{
+	search_options();
+
+	// 0 for one per processor
+	unsigned threads;
+
+	unsigned rounds;
+
+	unsigned candidates;
+
+	std::uint32_t seed;
+};
+
+
+/*
+ * Searches the bounds and fan rates of a configuration that keep a recorded
+ * trace within the thermal model's ceilings at the lowest mean PWM. Every
+ * candidate is simulated in closed loop with the daemon's control plan and
+ * fan logic: the zone temperatures follow the model from the recording, and
+ * the controls react to them as the daemon would.
+ *
+ * Rounds of candidates are perturbed from the best so far with a halving
+ * step size and evaluated in parallel. Candidates only depend on the seed,
+ * round and number, so the result doesn't depend on the number of threads.
+ */
+class optimizer
+{
+public:
+	optimizer(const config &cfg, const telemetry::trace &trace, const thermal_model &model);
+
+	parameters initial() const;
+
+	// thread-safe
+	score evaluate(const parameters &p) const;
+
+	parameters search(const search_options &opt, score &best) const;
+
+	// Writes the parameters into the configuration document the daemon parsed.
+	void apply(config &cfg, const parameters &p, YAML::Node &doc) const;
+
+private:
+	parameters perturb(const parameters &p, double scale, std::uint32_t round,
+		std::uint32_t candidate, std::uint32_t seed) const;
+
+	void apply_dependencies(config &cfg, const parameters &p, YAML::Node node) const;
+
+	const telemetry::trace &m_trace;
+
+	control_plan m_plan;
+
+	double m_interval;
+
+	// trace channel of each sample
+	std::vector<std::size_t> m_columns;
+
+	// per plan source
+	std::vector<zone_model> m_zones;
+
+	std::vector< std::vector<std::size_t> > m_zone_fans;
+
+	std::vector<std::size_t> m_source_of_sample;
+
+	// per fan
+	std::vector<control_plan::index_type> m_fan_nodes;
+
+	std::vector<std::size_t> m_gauges;
+
+	// trace channel of the recorded PWM value, or npos
+	std::vector<std::size_t> m_pwm_columns;
+
+	parameters m_initial;
+};
+
+	} /* namespace optimize */
+} /* namespace fancontrol */
+#endif /* FANCONTROL_OPTIMIZER_HPP_ */
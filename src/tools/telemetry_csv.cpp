@@ -0,0 +1,112 @@
+/*
+ * telemetry_csv.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+/*
+ * fancontrol2-telemetry-csv: prints the records of a telemetry file as CSV,
+ * oldest first, with one column per channel after the sequence number and
+ * the time in seconds since the epoch.
+ */
+
+#include "../telemetry.hpp"
+
+#include <boost/exception/diagnostic_information.hpp>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <unistd.h>
+
+
+namespace {
+
+using namespace fancontrol::telemetry;
+
+
+void usage(const char *argv0, std::ostream &out)
+{
+	out << "Usage: " << argv0 << " [-n RECORDS] [-k] FILE\n"
+		"\n"
+		"Prints the telemetry records in FILE as CSV, or only the last RECORDS.\n"
+		"With -k, the column names are prefixed with the channel kind.\n";
+}
+
+
+// Names are written as is unless they need quoting.
+void write_name(std::ostream &out, const std::string &s)
+{
+	const char *name = s.c_str();
+	if (!std::strpbrk(name, ",\"\n")) {
+		out << name;
+		return;
+	}
+	out << '"';
+	for (; *name; ++name) {
+		if (*name == '"')
+			out << '"';
+		out << *name;
+	}
+	out << '"';
+}
+
+}
+
+
+int main(int argc, char *argv[])
+{
+	unsigned long long last = 0;
+	bool kinds = false;
+
+	int opt;
+	while ((opt = ::getopt(argc, argv, "n:kh")) != -1) {
+		switch (opt) {
+		case 'n': last = std::strtoull(optarg, nullptr, 10); break;
+		case 'k': kinds = true; break;
+		case 'h':
+			usage(argv[0], std::cout);
+			return EXIT_SUCCESS;
+		default:
+			usage(argv[0], std::cerr);
+			return EXIT_FAILURE;
+		}
+	}
+	if (optind + 1 != argc) {
+		usage(argv[0], std::cerr);
+		return EXIT_FAILURE;
+	}
+
+	try {
+		const trace t(argv[optind]);
+
+		std::cout << "sequence,time";
+		for (const channel &c : t.channels()) {
+			std::string name(c.name);
+			if (kinds)
+				name.insert(0, std::string(to_string(static_cast<channel_kind>(c.kind))) + ':');
+			std::cout << ',';
+			write_name(std::cout, name);
+		}
+		std::cout << '\n' << std::setprecision(7);
+
+		for (std::size_t i = (last != 0 && last < t.size()) ? t.size() - last : 0; i < t.size(); i++) {
+			const float *const values = t.values(i);
+			write_time(std::cout << t.record(i).sequence << ',', t.record(i).time_ns);
+			for (std::size_t k = 0; k < t.channels().size(); k++) {
+				std::cout << ',';
+				if (!std::isnan(values[k]))
+					std::cout << values[k];
+			}
+			std::cout << '\n';
+		}
+	} catch (boost::exception &e) {
+		std::cerr << boost::diagnostic_information(e) << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return std::cout.flush() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
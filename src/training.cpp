@@ -0,0 +1,205 @@
+/*
+ * training.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "training.hpp"
+#include "config.hpp"
+#include "main_loop.hpp"
+#include "mock/hwmon.hpp"
+#include "mock/environment.hpp"
+#include "sensors++/sensors.hpp"
+#include "util/clock.hpp"
+
+#include <boost/throw_exception.hpp>
+#include <iostream>
+#include <sstream>
+#include <random>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <unistd.h>
+
+
+namespace fancontrol {
+
+using mock::hwmon_tree;
+using sensors::sensor_container;
+
+
+namespace {
+
+	struct phase
+	{
+		// seconds and degrees Celsius
+		double duration, from, to;
+
+		// approach the target exponentially like a cooling body
+		bool exponential;
+	};
+
+	const phase trace[] = {
+		{  90, 38, 38, false },  // idle
+		{  45, 38, 72, false },  // ramp
+		{  90, 72, 72, false },  // load
+		{ 120, 72, 38, true },   // cool-down
+		{  60, 38, 38, false },  // idle
+	};
+
+
+	double trace_duration()
+	{
+		double d = 0;
+		for (const phase &p : trace)
+			d += p.duration;
+		return d;
+	}
+
+
+	double temperature(double t)
+	{
+		t = std::fmod(t, trace_duration());
+		for (const phase &p : trace) {
+			if (t < p.duration) {
+				const double x = t / p.duration;
+				const double w = p.exponential ? 1 - std::exp(-5 * x) : x;
+				return p.from + (p.to - p.from) * w;
+			}
+			t -= p.duration;
+		}
+		return trace[0].from;
+	}
+
+
+	std::string attribute(const char *prefix, unsigned number, const char *suffix = "")
+	{
+		std::ostringstream s;
+		s << prefix << number << suffix;
+		return s.str();
+	}
+
+
+	// Every chip runs a little hotter than the one before and every input
+	// than its predecessor, with some sensor noise.
+	void heat(const hwmon_tree &tree, double base, std::minstd_rand &rng)
+	{
+		std::uniform_real_distribution<double> noise(-0.3, 0.3);
+		for (unsigned c = 0; c < tree.chip_count(); c++) {
+			for (unsigned i = 1; i <= tree.chip(c).temps; i++) {
+				const double t = base + 1.5 * c + 0.7 * (i - 1) + noise(rng);
+				tree.write(c, attribute("temp", i, "_input"), std::lround(t * 1000));
+			}
+		}
+	}
+
+
+	// Fans stand still without power and turn faster with it.
+	void spin(const hwmon_tree &tree)
+	{
+		for (unsigned c = 0; c < tree.chip_count(); c++) {
+			const hwmon_tree::chip_spec &spec = tree.chip(c);
+			for (unsigned f = 1; f <= spec.fans && f <= spec.pwms; f++) {
+				const long pwm = tree.read(c, attribute("pwm", f));
+				tree.write(c, attribute("fan", f, "_input"), (pwm > 0) ? 400 + 6 * pwm : 0);
+			}
+		}
+	}
+
+
+}
+
+
+training::training()
+	: cycles(3)
+	, chips(4)
+{
+}
+
+
+int training::run() const
+{
+	if (!std::strstr(sensors::libsensors_version, FANCONTROL_MOCK_VERSION_TAG)) {
+		BOOST_THROW_EXCEPTION(std::runtime_error(
+			"Training needs the libsensors stand-in; run with "
+			"LD_PRELOAD=libfancontrol2-sensors-mock.so"));
+	}
+
+	// Every tick rewrites the attribute files, which disk file systems like
+	// ext4 flush on close after a truncation; that takes longer than the
+	// ticks. So the tree goes to /dev/shm unless TMPDIR says otherwise.
+	const char *const shm = "/dev/shm";
+	const bool use_shm = !std::getenv("TMPDIR") && ::access(shm, W_OK | X_OK) == 0;
+
+	// The stand-in reads the root from the environment at initialisation.
+	const std::string root(hwmon_tree::make_temp_root(use_shm ? shm : nullptr));
+	::setenv(FANCONTROL_MOCK_HWMON_ENV, root.c_str(), 1);
+	hwmon_tree tree(root);
+	tree.keep(false);
+	for (unsigned i = 0; i < chips; i++)
+		tree.add_chip(hwmon_tree::chip_spec(6, 2, 2));
+
+	const shared_ptr<sensor_container> sensors(util::make_shared<sensor_container>("/dev/null"));
+	std::minstd_rand rng(1);
+	const util::real_clock wall_clock;
+	const double start = wall_clock.seconds(), duration = cycles * trace_duration();
+	unsigned long ticks = 0;
+
+	// with keep_open/direct_read, recording telemetry and publishing the
+	// state like a daemon would, and with the defaults; the interval is fixed,
+	// so every phase of the trace gets many ticks
+	for (const bool direct : { true, false }) {
+		hwmon_tree::config_options options;
+		options.interval = 1;
+		options.dependencies = 3;
+		options.keep_open = options.direct_read = direct;
+		if (direct) {
+			options.telemetry = root + "/telemetry";
+			options.status_segment = root + "/status";
+		}
+		std::stringstream text;
+		tree.write_config(text, options);
+
+		config cfg(text, sensors);
+		struct timespec interval;
+		cfg.interval(&interval);
+		util::virtual_clock clock;
+		main_loop loop(cfg, interval, &clock);
+
+		ticks += loop.run_until(util::to_timespec(duration),
+			[&tree, &rng](const struct timespec &now) {
+				spin(tree);
+				heat(tree, temperature(util::to_seconds(now)), rng);
+			});
+	}
+
+	std::clog << "Trained " << ticks << " ticks over " << 2 * duration
+		<< " s of simulated time in " << (wall_clock.seconds() - start) << " s" << std::endl;
+	return EXIT_SUCCESS;
+}
+
+} /* namespace fancontrol */
+
+
+#if FANCONTROL_TRAINING
+/*
+ * Keeps the training mode out of fancontrol::main, so that the Profile build
+ * compiles it like the Release build that uses its profile.
+ */
+int main(int argc, char *argv[])
+{
+	if (argc >= 2 && std::strcmp(argv[1], "--train") == 0) {
+		fancontrol::training t;
+		if (argc >= 3)
+			t.cycles = static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10));
+		try {
+			return t.run();
+		} catch (std::exception &e) {
+			std::cerr << "Training failed: " << e.what() << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+	return fancontrol::main(argc, argv);
+}
+#endif
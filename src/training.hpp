@@ -0,0 +1,48 @@
+/*
+ * training.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef FANCONTROL_TRAINING_HPP_
+#define FANCONTROL_TRAINING_HPP_
+
+
+// whether "fancontrol2 --train" exists; only instrumented builds need it
+#ifndef FANCONTROL_TRAINING
+#	define FANCONTROL_TRAINING (0)
+#endif
+
+
+namespace fancontrol {
+
+/*
+ * A workload for profile-guided optimisation that needs no hardware: drives
+ * the real control loop through a mock hwmon tree along a scripted
+ * temperature trace of idle, ramp, load and cool-down phases on a virtual
+ * clock, so that no tick waits.
+ *
+ * The daemon must run with the libsensors stand-in, e.g. with
+ * LD_PRELOAD=libfancontrol2-sensors-mock.so or as fancontrol2_mock. Only the
+ * Profile build and fancontrol2_mock define FANCONTROL_TRAINING and offer it
+ * as "--train [CYCLES]".
+ */
+struct training
+{
+	training();
+
+	// repetitions of the trace per configuration variant
+	unsigned cycles;
+
+	unsigned chips;
+
+	int run() const;
+};
+
+
+// the daemon's entry point, see fancontrol2.cpp
+int main(int argc, char *argv[]);
+
+} /* namespace fancontrol */
+#endif /* FANCONTROL_TRAINING_HPP_ */
@@ -0,0 +1,119 @@
+/*
+ * clock.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "clock.hpp"
+#include "assert.hpp"
+
+#include <boost/assert.hpp>
+#include <cerrno>
+#include <cmath>
+
+
+namespace util {
+
+clock::~clock()
+{
+}
+
+
+double clock::seconds() const
+{
+	return to_seconds(now());
+}
+
+
+real_clock::real_clock(clockid_t id)
+	: m_id(id)
+{
+}
+
+
+real_clock::~real_clock()
+{
+}
+
+
+struct timespec real_clock::now() const
+{
+	struct timespec t;
+	BOOST_VERIFY_P(::clock_gettime(m_id, &t) == 0);
+	return t;
+}
+
+
+void real_clock::sleep_until(const struct timespec &deadline)
+{
+	int r;
+	while ((r = ::clock_nanosleep(m_id, TIMER_ABSTIME, &deadline, nullptr)) == EINTR)
+		;
+	BOOST_ASSERT(r == 0);
+}
+
+
+virtual_clock::virtual_clock(const struct timespec &start)
+	: m_now(start)
+{
+}
+
+
+virtual_clock::~virtual_clock()
+{
+}
+
+
+struct timespec virtual_clock::now() const
+{
+	return m_now;
+}
+
+
+void virtual_clock::sleep_until(const struct timespec &deadline)
+{
+	if (timespec_less(m_now, deadline))
+		m_now = deadline;
+}
+
+
+void virtual_clock::advance(const struct timespec &duration)
+{
+	timespec_add(m_now, duration);
+}
+
+
+void virtual_clock::advance(double seconds)
+{
+	advance(to_timespec(seconds));
+}
+
+
+struct timespec &timespec_add(struct timespec &a, const struct timespec &b)
+{
+	a.tv_sec += b.tv_sec;
+	a.tv_nsec += b.tv_nsec;
+	if (a.tv_nsec >= 1000000000L) {
+		a.tv_nsec -= 1000000000L;
+		a.tv_sec++;
+	}
+	return a;
+}
+
+
+struct timespec to_timespec(double seconds)
+{
+	double whole;
+	struct timespec t;
+	t.tv_nsec = static_cast<long>(std::modf(seconds, &whole) * 1e+9);
+	t.tv_sec = static_cast<time_t>(whole);
+	return t;
+}
+
+
+double to_seconds(const struct timespec &t)
+{
+	return static_cast<double>(t.tv_sec) + static_cast<double>(t.tv_nsec) * 1e-9;
+}
+
+} /* namespace util */
@@ -0,0 +1,116 @@
+/*
+ * clock.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef UTIL_CLOCK_HPP_
+#define UTIL_CLOCK_HPP_
+
+#include <ctime>
+#include <cstdint>
+
+
+namespace util {
+
+/*
+ * The source of time for everything that measures or waits for intervals.
+ * real_clock reads and sleeps on a system clock; virtual_clock only moves
+ * when advanced or slept on, so a simulation runs through hours of ticks
+ * without waiting.
+ */
+class clock
+{
+public:
+	virtual ~clock();
+
+	virtual struct timespec now() const = 0;
+
+	// Returns once the clock has reached the given absolute time.
+	virtual void sleep_until(const struct timespec &deadline) = 0;
+
+	double seconds() const;
+};
+
+
+class real_clock
+	: public clock
+{
+public:
+	explicit real_clock(clockid_t id = CLOCK_MONOTONIC);
+
+	virtual ~real_clock();
+
+	virtual struct timespec now() const;
+
+	virtual void sleep_until(const struct timespec &deadline);
+
+	clockid_t id() const;
+
+private:
+	clockid_t m_id;
+};
+
+
+class virtual_clock
+	: public clock
+{
+public:
+	explicit virtual_clock(const struct timespec &start = timespec());
+
+	virtual ~virtual_clock();
+
+	virtual struct timespec now() const;
+
+	// Jumps to the deadline unless it already passed.
+	virtual void sleep_until(const struct timespec &deadline);
+
+	void advance(const struct timespec &duration);
+
+	void advance(double seconds);
+
+private:
+	struct timespec m_now;
+};
+
+
+struct timespec &timespec_add(struct timespec &a, const struct timespec &b);
+
+bool timespec_less(const struct timespec &a, const struct timespec &b);
+
+struct timespec to_timespec(double seconds);
+
+double to_seconds(const struct timespec &t);
+
+// CLOCK_MONOTONIC in nanoseconds, for measuring durations
+std::uint64_t monotonic_ns();
+
+
+
+// implementations ========================================
+
+inline
+clockid_t real_clock::id() const
+{
+	return m_id;
+}
+
+
+inline
+std::uint64_t monotonic_ns()
+{
+	struct timespec t;
+	::clock_gettime(CLOCK_MONOTONIC, &t);
+	return static_cast<std::uint64_t>(t.tv_sec) * 1000000000u + static_cast<std::uint64_t>(t.tv_nsec);
+}
+
+
+inline
+bool timespec_less(const struct timespec &a, const struct timespec &b)
+{
+	return (a.tv_sec != b.tv_sec) ? a.tv_sec < b.tv_sec : a.tv_nsec < b.tv_nsec;
+}
+
+} /* namespace util */
+#endif /* UTIL_CLOCK_HPP_ */
@@ -0,0 +1,299 @@
+/*
+ * event_loop.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "event_loop.hpp"
+#include "exception.hpp"
+#include "assert.hpp"
+
+#include <boost/assert.hpp>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+
+
+namespace util {
+
+namespace {
+
+	void throw_errno(const char *what, int errnum = errno)
+	{
+		BOOST_THROW_EXCEPTION(io_error()
+			<< io_error::what_t(what)
+			<< io_error::errno_code(errnum));
+	}
+
+
+	void throw_errno(const char *what, const std::string &path, int errnum = errno)
+	{
+		BOOST_THROW_EXCEPTION(io_error()
+			<< io_error::what_t(what)
+			<< io_error::filename(path)
+			<< io_error::errno_code(errnum));
+	}
+
+
+	// a socket that nobody listens on any more, left behind by a crash
+	bool is_stale_socket(const struct sockaddr_un &addr)
+	{
+		struct stat st;
+		if (::lstat(addr.sun_path, &st) != 0 || !S_ISSOCK(st.st_mode))
+			return false;
+
+		const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (fd < 0)
+			return false;
+		const bool refused = ::connect(fd, reinterpret_cast<const struct sockaddr*>(&addr),
+			sizeof(addr)) != 0 && errno == ECONNREFUSED;
+		::close(fd);
+		return refused;
+	}
+
+}
+
+
+event_loop::event_loop()
+	: m_fd(::epoll_create1(EPOLL_CLOEXEC))
+	, m_stopped(false)
+	, m_exit_code(0)
+{
+	if (m_fd < 0)
+		throw_errno("Could not create an epoll instance");
+}
+
+
+event_loop::~event_loop()
+{
+	::close(m_fd);
+}
+
+
+void event_loop::add(int fd, std::uint32_t events, const handler_type &handler)
+{
+	BOOST_ASSERT(fd >= 0);
+	BOOST_ASSERT(handler);
+	struct epoll_event ev = {};
+	ev.events = events;
+	ev.data.fd = fd;
+	if (::epoll_ctl(m_fd, EPOLL_CTL_ADD, fd, &ev) != 0)
+		throw_errno("Could not register a file descriptor for polling");
+	m_handlers[fd] = handler;
+}
+
+
+void event_loop::modify(int fd, std::uint32_t events)
+{
+	BOOST_ASSERT(m_handlers.count(fd) != 0);
+	struct epoll_event ev = {};
+	ev.events = events;
+	ev.data.fd = fd;
+	if (::epoll_ctl(m_fd, EPOLL_CTL_MOD, fd, &ev) != 0)
+		throw_errno("Could not modify a polled file descriptor");
+}
+
+
+void event_loop::remove(int fd)
+{
+	if (m_handlers.erase(fd) != 0)
+		BOOST_VERIFY_P(::epoll_ctl(m_fd, EPOLL_CTL_DEL, fd, nullptr) == 0);
+}
+
+
+int event_loop::run_once(int timeout_ms)
+{
+	struct epoll_event events[16];
+	const int n = ::epoll_wait(m_fd, events, 16, timeout_ms);
+	if (n < 0) {
+		if (errno == EINTR)
+			return 0;
+		throw_errno("epoll_wait() failed");
+	}
+
+	for (int i = 0; i < n && !m_stopped; i++) {
+		// a previous handler may have removed this descriptor
+		const std::unordered_map<int, handler_type>::const_iterator it =
+			m_handlers.find(events[i].data.fd);
+		if (it != m_handlers.end()) {
+			const handler_type handler(it->second);
+			handler(events[i].events);
+		}
+	}
+	return n;
+}
+
+
+int event_loop::run()
+{
+	m_stopped = false;
+	while (!m_stopped)
+		run_once();
+	return m_exit_code;
+}
+
+
+void event_loop::stop(int exit_code)
+{
+	m_exit_code = exit_code;
+	m_stopped = true;
+}
+
+
+timer_source::timer_source(clockid_t clock)
+	: m_clock(clock)
+	, m_fd(::timerfd_create(clock, TFD_CLOEXEC | TFD_NONBLOCK))
+{
+	if (m_fd < 0)
+		throw_errno("Could not create a timer");
+}
+
+
+timer_source::~timer_source()
+{
+	::close(m_fd);
+}
+
+
+void timer_source::arm(const struct timespec &interval)
+{
+	struct timespec deadline;
+	BOOST_VERIFY_P(::clock_gettime(m_clock, &deadline) == 0);
+	arm(timespec_add(deadline, interval), interval);
+}
+
+
+void timer_source::arm(const struct timespec &deadline, const struct timespec &interval)
+{
+	struct itimerspec spec;
+	spec.it_value = deadline;
+	spec.it_interval = interval;
+	if (::timerfd_settime(m_fd, TFD_TIMER_ABSTIME, &spec, nullptr) != 0)
+		throw_errno("Could not arm a timer");
+}
+
+
+void timer_source::disarm()
+{
+	const struct itimerspec spec = {};
+	BOOST_VERIFY_P(::timerfd_settime(m_fd, 0, &spec, nullptr) == 0);
+}
+
+
+std::uint64_t timer_source::expirations()
+{
+	std::uint64_t n;
+	if (::read(m_fd, &n, sizeof(n)) != static_cast<ssize_t>(sizeof(n))) {
+		if (errno != EAGAIN)
+			throw_errno("Could not read from a timer");
+		n = 0;
+	}
+	return n;
+}
+
+
+signal_source::signal_source(std::initializer_list<int> signals)
+{
+	BOOST_VERIFY_P(::sigemptyset(&m_mask) == 0);
+	for (const int signal : signals)
+		BOOST_VERIFY_P(::sigaddset(&m_mask, signal) == 0);
+
+	if (::sigprocmask(SIG_BLOCK, &m_mask, nullptr) != 0)
+		throw_errno("Could not block signals");
+
+	m_fd = ::signalfd(-1, &m_mask, SFD_CLOEXEC | SFD_NONBLOCK);
+	if (m_fd < 0) {
+		const int errnum = errno;
+		::sigprocmask(SIG_UNBLOCK, &m_mask, nullptr);
+		throw_errno("Could not create a signal descriptor", errnum);
+	}
+}
+
+
+signal_source::~signal_source()
+{
+	::close(m_fd);
+	::sigprocmask(SIG_UNBLOCK, &m_mask, nullptr);
+}
+
+
+bool signal_source::read(int &signal)
+{
+	struct signalfd_siginfo info;
+	if (::read(m_fd, &info, sizeof(info)) != static_cast<ssize_t>(sizeof(info))) {
+		if (errno != EAGAIN)
+			throw_errno("Could not read from a signal descriptor");
+		return false;
+	}
+	signal = static_cast<int>(info.ssi_signo);
+	return true;
+}
+
+listen_socket::listen_socket(const std::string &path, mode_t mode, int backlog)
+	: m_path(path)
+	, m_fd(::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0))
+{
+	if (m_fd < 0)
+		throw_errno("Could not create a socket", path);
+
+	struct sockaddr_un addr = {};
+	addr.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(addr.sun_path)) {
+		::close(m_fd);
+		throw_errno("Socket path too long", path, ENAMETOOLONG);
+	}
+	std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+	if (is_stale_socket(addr))
+		::unlink(path.c_str());
+	// The socket file takes the mode of the socket, less the umask.
+	if (::fchmod(m_fd, mode) != 0 ||
+		::bind(m_fd, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) != 0 ||
+		::listen(m_fd, backlog) != 0)
+	{
+		const int errnum = errno;
+		::close(m_fd);
+		throw_errno("Could not listen on a socket", path, errnum);
+	}
+}
+
+
+listen_socket::~listen_socket()
+{
+	::close(m_fd);
+	::unlink(m_path.c_str());
+}
+
+
+int listen_socket::accept()
+{
+	const int fd = ::accept4(m_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+	if (fd < 0) {
+		switch (errno) {
+			case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+			case EWOULDBLOCK:
+#endif
+			case ECONNABORTED:
+			case EINTR:
+			case EPROTO:
+			case EMFILE:
+			case ENFILE:
+			case ENOBUFS:
+			case ENOMEM:
+				// nothing pending, or try again later
+				break;
+			default:
+				throw_errno("Could not accept a connection", m_path);
+		}
+	}
+	return fd;
+}
+
+} /* namespace util */
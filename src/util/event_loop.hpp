@@ -0,0 +1,214 @@
+/*
+ * event_loop.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef UTIL_EVENT_LOOP_HPP_
+#define UTIL_EVENT_LOOP_HPP_
+
+#include "clock.hpp"
+
+#include <functional>
+#include <unordered_map>
+#include <initializer_list>
+#include <string>
+#include <cstdint>
+#include <csignal>
+#include <ctime>
+#include <sys/types.h>
+
+
+namespace util {
+
+/*
+ * A minimal epoll reactor: file descriptors are registered together with a
+ * handler, which is invoked with the ready event mask. Everything the daemon
+ * waits for shares the single epoll_wait() call in run_once().
+ */
+class event_loop
+{
+public:
+	typedef std::function<void(std::uint32_t events)> handler_type;
+
+	event_loop();
+
+	~event_loop();
+
+	void add(int fd, std::uint32_t events, const handler_type &handler);
+
+	void modify(int fd, std::uint32_t events);
+
+	void remove(int fd);
+
+	int run_once(int timeout_ms = -1);
+
+	int run();
+
+	void stop(int exit_code = 0);
+
+	bool stopped() const;
+
+	int fd() const;
+
+private:
+	event_loop(const event_loop&) = delete;
+
+	event_loop &operator=(const event_loop&) = delete;
+
+	int m_fd;
+
+	bool m_stopped;
+
+	int m_exit_code;
+
+	std::unordered_map<int, handler_type> m_handlers;
+};
+
+
+/*
+ * A timerfd, that expires periodically at absolute deadlines, so the period
+ * does not drift by the time spent handling each expiration.
+ */
+class timer_source
+{
+public:
+	explicit timer_source(clockid_t clock = CLOCK_MONOTONIC);
+
+	~timer_source();
+
+	void arm(const struct timespec &interval);
+
+	void arm(const struct timespec &deadline, const struct timespec &interval);
+
+	void disarm();
+
+	std::uint64_t expirations();
+
+	clockid_t clock() const;
+
+	int fd() const;
+
+private:
+	timer_source(const timer_source&) = delete;
+
+	timer_source &operator=(const timer_source&) = delete;
+
+	clockid_t m_clock;
+
+	int m_fd;
+};
+
+
+/*
+ * A signalfd for a set of signals, which are blocked for the lifetime of
+ * this object so they are delivered synchronously through the descriptor.
+ */
+class signal_source
+{
+public:
+	explicit signal_source(std::initializer_list<int> signals);
+
+	~signal_source();
+
+	bool read(int &signal);
+
+	int fd() const;
+
+private:
+	signal_source(const signal_source&) = delete;
+
+	signal_source &operator=(const signal_source&) = delete;
+
+	sigset_t m_mask;
+
+	int m_fd;
+};
+
+
+
+/*
+ * A non-blocking Unix domain stream socket listening at a path with the
+ * given mode. A stale socket at that path, which refuses connections, is
+ * replaced; anything else there is left alone and fails the bind. The path
+ * is removed again on destruction.
+ */
+class listen_socket
+{
+public:
+	explicit listen_socket(const std::string &path, mode_t mode = 0600, int backlog = 8);
+
+	~listen_socket();
+
+	// Returns a non-blocking connection or -1 if none is pending.
+	int accept();
+
+	const std::string &path() const;
+
+	int fd() const;
+
+private:
+	listen_socket(const listen_socket&) = delete;
+
+	listen_socket &operator=(const listen_socket&) = delete;
+
+	std::string m_path;
+
+	int m_fd;
+};
+
+
+
+// implementations ========================================
+
+inline
+bool event_loop::stopped() const
+{
+	return m_stopped;
+}
+
+
+inline
+int event_loop::fd() const
+{
+	return m_fd;
+}
+
+
+inline
+clockid_t timer_source::clock() const
+{
+	return m_clock;
+}
+
+
+inline
+int timer_source::fd() const
+{
+	return m_fd;
+}
+
+
+inline
+int signal_source::fd() const
+{
+	return m_fd;
+}
+
+
+inline
+const std::string &listen_socket::path() const
+{
+	return m_path;
+}
+
+
+inline
+int listen_socket::fd() const
+{
+	return m_fd;
+}
+
+} /* namespace util */
+#endif /* UTIL_EVENT_LOOP_HPP_ */
@@ -0,0 +1,53 @@
+/*
+ * hash.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef UTIL_HASH_HPP_
+#define UTIL_HASH_HPP_
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+
+namespace util {
+
+/*
+ * 64-bit FNV-1a, to recognise content that was seen before. Not meant to
+ * withstand deliberate collisions. Hashes of several pieces are chained by
+ * passing the previous result as the basis.
+ */
+const std::uint64_t fnv1a_basis = 0xcbf29ce484222325ull;
+
+std::uint64_t fnv1a(const void *data, std::size_t size, std::uint64_t hash = fnv1a_basis);
+
+std::uint64_t fnv1a(const std::string &s, std::uint64_t hash = fnv1a_basis);
+
+
+
+// implementations ========================================
+
+inline
+std::uint64_t fnv1a(const void *data, std::size_t size, std::uint64_t hash)
+{
+	const unsigned char *p = static_cast<const unsigned char*>(data);
+	for (const unsigned char *const end = p + size; p != end; ++p) {
+		hash ^= *p;
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+
+inline
+std::uint64_t fnv1a(const std::string &s, std::uint64_t hash)
+{
+	// with the terminator, so adjacent strings can't run into each other
+	return fnv1a(s.c_str(), s.size() + 1, hash);
+}
+
+} /* namespace util */
+#endif /* UTIL_HASH_HPP_ */
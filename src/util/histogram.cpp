@@ -0,0 +1,90 @@
+/*
+ * histogram.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "histogram.hpp"
+
+#include <ostream>
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <cmath>
+
+
+namespace util {
+
+const unsigned histogram::sub_bucket_bits, histogram::max_bits;
+const histogram::value_type histogram::sub_buckets;
+const std::size_t histogram::bucket_count;
+
+
+histogram::histogram()
+{
+	reset();
+}
+
+
+void histogram::reset()
+{
+	m_counts.fill(0);
+	m_count = 0;
+	m_min = std::numeric_limits<value_type>::max();
+	m_max = 0;
+	m_sum = 0;
+}
+
+
+double histogram::mean() const
+{
+	return m_count ? static_cast<double>(m_sum) / static_cast<double>(m_count) : 0;
+}
+
+
+histogram::value_type histogram::highest_equivalent(std::size_t index)
+{
+	if (index < 2 * sub_buckets)
+		return index;
+	const unsigned shift = static_cast<unsigned>(index / sub_buckets - 1);
+	const value_type sub = index - shift * sub_buckets;
+	return ((sub + 1) << shift) - 1;
+}
+
+
+histogram::value_type histogram::percentile(double p) const
+{
+	if (m_count == 0)
+		return 0;
+
+	const double rank = std::ceil(p / 100 * static_cast<double>(m_count));
+	const std::uint64_t target = (rank < 1) ? 1 : static_cast<std::uint64_t>(rank);
+	std::uint64_t seen = 0;
+	for (std::size_t i = 0; i < bucket_count; i++) {
+		seen += m_counts[i];
+		if (seen >= target)
+			return std::min(highest_equivalent(i), m_max);
+	}
+	return m_max;
+}
+
+
+std::ostream &operator<<(std::ostream &out, const histogram &h)
+{
+	static const struct { const char *label; double p; } percentiles[] = {
+		{ "p50", 50 }, { "p90", 90 }, { "p99", 99 }, { "p99.9", 99.9 },
+	};
+	const std::ios::fmtflags flags = out.flags(std::ios::fixed);
+	const std::streamsize precision = out.precision(1);
+
+	out << "n=" << h.count() << " mean=" << h.mean() * 1e-3;
+	for (const auto &p : percentiles)
+		out << ' ' << p.label << '=' << static_cast<double>(h.percentile(p.p)) * 1e-3;
+	out << " max=" << static_cast<double>(h.max()) * 1e-3;
+
+	out.precision(precision);
+	out.flags(flags);
+	return out;
+}
+
+} /* namespace util */
@@ -0,0 +1,136 @@
+/*
+ * histogram.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef UTIL_HISTOGRAM_HPP_
+#define UTIL_HISTOGRAM_HPP_
+
+#include <array>
+#include <iosfwd>
+#include <cstdint>
+
+
+namespace util {
+
+/*
+ * A histogram of durations in nanoseconds with HDR-style log-linear
+ * buckets: every power of two is split into sub_buckets equal buckets, so
+ * every recorded value is known to within 1/sub_buckets (about 3 %). Values
+ * up to 2^max_bits ns (about a minute) are kept apart; larger ones share the
+ * last bucket. The buckets are a fixed array, so recording neither
+ * allocates nor fails.
+ */
+class histogram
+{
+public:
+	typedef std::uint64_t value_type;
+
+	static const unsigned sub_bucket_bits = 5, max_bits = 36;
+
+	static const value_type sub_buckets = static_cast<value_type>(1) << sub_bucket_bits;
+
+	static const std::size_t bucket_count = (max_bits - sub_bucket_bits + 2) * sub_buckets;
+
+	histogram();
+
+	void record(value_type value);
+
+	void reset();
+
+	std::uint64_t count() const;
+
+	value_type min() const;
+
+	value_type max() const;
+
+	double mean() const;
+
+	value_type sum() const;
+
+	// the highest value equivalent to the recorded value at that percentile
+	value_type percentile(double p) const;
+
+	static std::size_t index(value_type value);
+
+	static value_type highest_equivalent(std::size_t index);
+
+private:
+	std::array<std::uint32_t, bucket_count> m_counts;
+
+	std::uint64_t m_count;
+
+	value_type m_min, m_max;
+
+	// sum of all values for the mean; wraps after centuries of ticks
+	value_type m_sum;
+};
+
+
+// count, mean and selected percentiles in microseconds
+std::ostream &operator<<(std::ostream &out, const histogram &h);
+
+
+
+// implementations ========================================
+
+inline
+std::size_t histogram::index(value_type value)
+{
+	if (value < sub_buckets)
+		return static_cast<std::size_t>(value);
+
+	const unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(value));
+	if (msb > max_bits)
+		return bucket_count - 1;
+	const unsigned shift = msb - sub_bucket_bits;
+	return static_cast<std::size_t>(shift * sub_buckets + (value >> shift));
+}
+
+
+inline
+void histogram::record(value_type value)
+{
+	std::uint32_t &c = m_counts[index(value)];
+	if (c != UINT32_MAX)
+		c++;
+	m_count++;
+	m_sum += value;
+	if (value < m_min)
+		m_min = value;
+	if (value > m_max)
+		m_max = value;
+}
+
+
+inline
+std::uint64_t histogram::count() const
+{
+	return m_count;
+}
+
+
+inline
+histogram::value_type histogram::min() const
+{
+	return m_count ? m_min : 0;
+}
+
+
+inline
+histogram::value_type histogram::max() const
+{
+	return m_max;
+}
+
+
+inline
+histogram::value_type histogram::sum() const
+{
+	return m_sum;
+}
+
+} /* namespace util */
+#endif /* UTIL_HISTOGRAM_HPP_ */
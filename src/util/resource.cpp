@@ -0,0 +1,27 @@
+/*
+ * resource.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "resource.hpp"
+#include <cerrno>
+#include <sys/resource.h>
+
+
+namespace util {
+
+int raise_file_descriptor_limit()
+{
+	struct rlimit limit;
+	if (::getrlimit(RLIMIT_NOFILE, &limit) != 0)
+		return errno;
+	if (limit.rlim_cur != limit.rlim_max) {
+		limit.rlim_cur = limit.rlim_max;
+		if (::setrlimit(RLIMIT_NOFILE, &limit) != 0)
+			return errno;
+	}
+	return 0;
+}
+
+} /* namespace util */
@@ -0,0 +1,21 @@
+/*
+ * resource.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef UTIL_RESOURCE_HPP_
+#define UTIL_RESOURCE_HPP_
+
+
+namespace util {
+
+/*
+ * Raises the soft limit of open file descriptors to the hard limit. Returns 0
+ * on success or an errno value.
+ */
+int raise_file_descriptor_limit();
+
+} /* namespace util */
+#endif /* UTIL_RESOURCE_HPP_ */
@@ -0,0 +1,104 @@
+/*
+ * uring_batch.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "uring_batch.hpp"
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <cerrno>
+
+#if UTIL_IO_URING
+#	include <liburing.h>
+#endif
+
+
+namespace util {
+
+uring_batch::uring_batch()
+	: m_ring(nullptr)
+	, m_depth(0)
+{
+}
+
+
+uring_batch::~uring_batch()
+{
+#if UTIL_IO_URING
+	if (m_ring) {
+		io_uring_queue_exit(m_ring);
+		delete m_ring;
+	}
+#endif
+}
+
+
+int uring_batch::init(unsigned depth)
+{
+#if UTIL_IO_URING
+	BOOST_ASSERT(!m_ring);
+	BOOST_ASSERT(depth != 0);
+	depth = std::min(depth, 256U);
+
+	io_uring *const ring = new io_uring();
+	const int r = io_uring_queue_init(depth, ring, 0);
+	if (r < 0) {
+		delete ring;
+		return -r;
+	}
+
+	m_ring = ring;
+	m_depth = depth;
+	return 0;
+#else
+	static_cast<void>(depth);
+	return ENOSYS;
+#endif
+}
+
+
+int uring_batch::read(request *first, request *last)
+{
+#if UTIL_IO_URING
+	BOOST_ASSERT(m_ring);
+	while (first != last) {
+		unsigned n = 0;
+		for (; first != last && n < m_depth; ++first, ++n) {
+			io_uring_sqe *const sqe = io_uring_get_sqe(m_ring);
+			BOOST_ASSERT(sqe);
+			first->result = -ECANCELED;
+			io_uring_prep_read(sqe, first->fd, first->buffer, first->size, 0);
+			io_uring_sqe_set_data(sqe, first);
+		}
+
+		int r;
+		do {
+			r = io_uring_submit_and_wait(m_ring, n);
+		} while (r == -EINTR);
+		if (r < 0)
+			return -r;
+		BOOST_ASSERT(static_cast<unsigned>(r) == n);
+
+		while (n != 0) {
+			io_uring_cqe *cqe;
+			r = io_uring_wait_cqe(m_ring, &cqe);
+			if (r == -EINTR)
+				continue;
+			if (r < 0)
+				return -r;
+
+			static_cast<request*>(io_uring_cqe_get_data(cqe))->result = cqe->res;
+			io_uring_cqe_seen(m_ring, cqe);
+			n--;
+		}
+	}
+	return 0;
+#else
+	static_cast<void>(first);
+	static_cast<void>(last);
+	return ENOSYS;
+#endif
+}
+
+} /* namespace util */
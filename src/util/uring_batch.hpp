@@ -0,0 +1,85 @@
+/*
+ * uring_batch.hpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#pragma once
+#ifndef UTIL_URING_BATCH_HPP_
+#define UTIL_URING_BATCH_HPP_
+
+#include <cstddef>
+
+
+#ifndef UTIL_IO_URING
+#	define UTIL_IO_URING (0)
+#endif
+
+
+struct io_uring;
+
+namespace util {
+
+/*
+ * Submits a batch of positional reads as one io_uring submission and waits
+ * for all of them to complete.
+ *
+ * Experimental: this saves system calls, but whether the reads overlap is up
+ * to the kernel and the drivers. hwmon drivers usually serialise the reads of
+ * one chip on a per-device lock anyway. No measurement on real hardware backs
+ * a speed-up yet, and the mock environment can't delay io_uring reads.
+ *
+ * Without io_uring support at compile time (FANCONTROL_IO_URING), init()
+ * always fails with ENOSYS.
+ */
+class uring_batch
+{
+public:
+	struct request {
+		int fd;
+		char *buffer;
+		unsigned size;
+		int result;
+	};
+
+	uring_batch();
+
+	~uring_batch();
+
+	static bool available();
+
+	int init(unsigned depth);
+
+	bool initialized() const;
+
+	int read(request *first, request *last);
+
+private:
+	uring_batch(const uring_batch&) = delete;
+
+	uring_batch &operator=(const uring_batch&) = delete;
+
+	io_uring *m_ring;
+
+	unsigned m_depth;
+};
+
+
+
+// implementations ========================================
+
+inline
+bool uring_batch::available()
+{
+	return UTIL_IO_URING;
+}
+
+
+inline
+bool uring_batch::initialized() const
+{
+	return m_ring != nullptr;
+}
+
+} /* namespace util */
+#endif /* UTIL_URING_BATCH_HPP_ */
@@ -6,18 +6,20 @@
  */
 
 #include "utils.hpp"
+#include "config_cache.hpp"
 #include "sensors++/sensors.hpp"
 #include "util/assert.hpp"
 #include "util/preprocessor.hpp"
+#include "util/hash.hpp"
 
-#include <boost/foreach.hpp>
 #include <boost/preprocessor/stringize.hpp>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <iterator>
 
 #include <cerrno>
 #include <cstring>
-#include <csignal>
 #include <cstdlib>
 
 namespace fancontrol {
@@ -30,6 +32,31 @@ using std::cerr;
 using std::endl;
 
 
+#if FANCONTROL_PIDFILE
+#	ifndef FANCONTROL_PIDFILE_ROOTONLY
+#		ifdef NDEBUG
+#			define FANCONTROL_PIDFILE_ROOTONLY (1)
+#		else
+#			define FANCONTROL_PIDFILE_ROOTONLY (0)
+#		endif
+#	endif
+#	ifndef FANCONTROL_PIDFILE_PATH
+#		if FANCONTROL_PIDFILE_ROOTONLY
+#			define FANCONTROL_PIDFILE_PATH /var/run/fancontrol.pid
+#		else
+#			define FANCONTROL_PIDFILE_PATH fancontrol.pid
+#		endif
+#	endif
+#endif
+
+// the compiled configuration image is opt-in and always in one place
+#ifndef FANCONTROL_CONFIG_CACHE
+#	define FANCONTROL_CONFIG_CACHE (0)
+#endif
+#if FANCONTROL_CONFIG_CACHE && !defined(FANCONTROL_CONFIG_CACHE_PATH)
+#	define FANCONTROL_CONFIG_CACHE_PATH /var/cache/fancontrol2.bin
+#endif
+
 #ifndef FANCONTROL_CONFIGFILE
 #	ifdef NDEBUG
 #		define FANCONTROL_CONFIGFILE /etc/fancontrol2.yaml
@@ -85,87 +112,92 @@ int handle_exception(util::exception_base &e, bool cfg_ok)
 }
 
 
-static int last_signal;
-
-void handle_signal(int signal)
+config_wrapper::config_wrapper(
+	const char *filename, const util::shared_ptr<sensor_container> &sens,
+	bool do_check)
+	: do_check(do_check)
+	, replay_trace(nullptr)
+	, filename(filename)
 {
-	last_signal = signal;
-}
-
+	if (!do_check) {
+#if FANCONTROL_PIDFILE
+		m_pidfile.reset(new util::pidfile(
+				sensors::string_ref(BOOST_PP_STRINGIZE(FANCONTROL_PIDFILE_PATH)),
+				FANCONTROL_PIDFILE_ROOTONLY));
+#endif
+	}
 
-const struct sigaction *get_signal_action_definition()
-{
-	struct sigaction *signal_action_definition = new struct sigaction();
-	signal_action_definition->sa_handler = &handle_signal;
-	return signal_action_definition;
+	m_cfg = parse(filename, sens, do_check);
+	m_cfg->interval(&interval);
 }
 
 
-void register_signal_handlers()
+/*
+ * Unless only checking, a compiled image of the configuration is used if it
+ * was made from the same text on the same hwmon topology, and written anew
+ * after parsing otherwise. An image that doesn't load or resolve is
+ * ignored; the text is authoritative.
+ */
+std::unique_ptr<config> config_wrapper::parse(const char *filename,
+	const util::shared_ptr<sensor_container> &sens, bool do_check)
 {
-	static const struct sigaction *const signal_action_definition = get_signal_action_definition();
-	static const int signals[] = { SIGHUP, SIGINT, SIGQUIT, SIGPIPE, SIGTERM, SIGCONT };
-
-	last_signal = -1;
+	std::string text;
+	try {
+		std::ifstream cfg_file;
+		cfg_file.exceptions(std::ios::badbit);
+		cfg_file.open(filename);
+		text.assign(std::istreambuf_iterator<char>(cfg_file), std::istreambuf_iterator<char>());
+	} catch (std::ios::failure &e) {
+		using util::io_error;
+		BOOST_THROW_EXCEPTION(io_error()
+			<< io_error::what_t(e.what())
+			<< io_error::errno_code(errno)
+			<< io_error::filename(filename));
+	}
 
-	BOOST_FOREACH(const int signal, signals) {
-		BOOST_VERIFY_P(::sigaction(signal, signal_action_definition, nullptr) == 0);
+#if FANCONTROL_CONFIG_CACHE
+	const char *const cache_path = BOOST_PP_STRINGIZE(FANCONTROL_CONFIG_CACHE_PATH);
+	std::uint64_t source_hash = 0, topology_hash = 0;
+	if (!do_check) {
+		source_hash = util::fnv1a(text);
+		topology_hash = config_cache::topology_fingerprint(sensors::default_config_path);
+		try {
+			const config_cache::image image(cache_path);
+			if (image.matches(source_hash, topology_hash))
+				return std::unique_ptr<config>(new config(image, sens));
+		} catch (std::exception &e) {
+			UTIL_DEBUG(cerr << "Ignoring the compiled configuration: " << e.what() << endl);
+		}
 	}
-}
+#endif
 
+	std::istringstream source(text);
+	std::unique_ptr<config> cfg(new config(source, sens, do_check));
 
-int sleep_reset()
-{
-	const int return_value = -last_signal;
-	last_signal = -1;
-	return return_value;
+#if FANCONTROL_CONFIG_CACHE
+	if (!do_check) {
+		try {
+			config_cache::write(cache_path, *cfg, source_hash, topology_hash);
+		} catch (std::exception &e) {
+			cerr << "Could not compile the configuration: " << e.what() << endl;
+		}
+	}
+#endif
+	return cfg;
 }
 
 
-int sleep(const struct timespec *duration)
+std::unique_ptr<config> config_wrapper::load() const
 {
-	if (::nanosleep(duration, nullptr) == 0) {
-		// continue normally
-		return -1;
-	}
-
-	if (errno != EINTR) {
-		strerror_wrapper("'nanosleep' error");
-		return EXIT_FAILURE;
-	}
-
-	errno = 0;
-	BOOST_ASSERT(last_signal >= 0);
-	switch (last_signal) {
-		case SIGHUP:
-		case SIGINT:
-		case SIGQUIT:
-		case SIGTERM:
-			// no error, but request reset and leave
-			return EXIT_SUCCESS;
-
-		case SIGCONT:
-			// request to poll now (instead of waiting a whole interval)
-			return sleep_reset();
-
-		default:  // e.g. SIGPIPE
-			UTIL_DEBUG(std::cerr
-				<< "Interrupted by signal " << last_signal << std::endl);
-			break;
-	}
-
-	// reset and leave with non-zero return value
-	return 2;
+	return parse(filename.c_str(), m_cfg->sensors, do_check);
 }
 
 
-config_wrapper::config_wrapper(
-	std::ifstream &config_file, const util::shared_ptr<sensor_container> &sens,
-	bool do_check)
-	: cfg(config_file, sens, do_check)
-	, do_check(do_check)
+void config_wrapper::replace(std::unique_ptr<config> next)
 {
-	cfg.interval(&interval);
+	next->take_over(*m_cfg);
+	m_cfg = std::move(next);
+	m_cfg->interval(&interval);
 }
 
 
@@ -175,10 +207,16 @@ std::unique_ptr<config_wrapper> config_wrapper::make_config(
 	int argp = 1;
 	const char *cfg_filename = BOOST_PP_STRINGIZE(FANCONTROL_CONFIGFILE);
 	bool do_check = false;
+	const char *replay_trace = nullptr;
 
 	if (argp < argc && std::strcmp(argv[argp], "--check") == 0) {
 		argp++;
 		do_check = true;
+	} else if (argp + 1 < argc && std::strcmp(argv[argp], "--replay") == 0) {
+		// parsed like a check, so nothing is opened for writing
+		replay_trace = argv[argp + 1];
+		argp += 2;
+		do_check = true;
 	}
 
 	if (argp < argc) {
@@ -194,20 +232,13 @@ std::unique_ptr<config_wrapper> config_wrapper::make_config(
 	}
 
 
-	try {
-		std::ifstream cfg_file;
-		cfg_file.exceptions(std::ios::badbit);
-		cfg_file.open(cfg_filename);
-
-		return std::unique_ptr<config_wrapper>(
-				new config_wrapper(cfg_file, util::make_shared<sensor_container>(), do_check));
-	} catch (std::ios::failure &e) {
-		using util::io_error;
-		BOOST_THROW_EXCEPTION(io_error()
-			<< io_error::what_t(e.what())
-			<< io_error::errno_code(errno)
-			<< io_error::filename(cfg_filename));
+	std::unique_ptr<config_wrapper> wrapper(
+			new config_wrapper(cfg_filename, util::make_shared<sensor_container>(), do_check));
+	if (replay_trace) {
+		wrapper->replay_trace = replay_trace;
+		wrapper->cfg().auto_reset = false;
 	}
+	return wrapper;
 }
 
 }
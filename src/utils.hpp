@@ -9,8 +9,15 @@
 #ifndef FANCONTROL_UTILS_HPP_
 #define FANCONTROL_UTILS_HPP_
 
+#ifndef FANCONTROL_PIDFILE
+#	define FANCONTROL_PIDFILE (1)
+#endif
+
 #include "config.hpp"
 #include "util/memory.hpp"
+#if FANCONTROL_PIDFILE
+#	include "util/pidfile.hpp"
+#endif
 #include <exception>
 #include <memory>
 #include <ctime>
@@ -31,28 +38,56 @@ int handle_exception(std::exception &e, bool cfg_ok);
 int handle_exception(util::exception_base &e, bool cfg_ok);
 
 
-void register_signal_handlers();
-
-
-int sleep(const struct timespec *duration);
-
-
 class config_wrapper {
 public:
 	config_wrapper(
-		std::ifstream &config_file,
+		const char *filename,
 		const util::shared_ptr< sensors::sensor_container > &sensors,
 		bool do_check);
 
 	static std::unique_ptr<config_wrapper> make_config(int argc, char *argv[]);
 
-	config cfg;
+	config &cfg();
+
+	/*
+	 * Parses the configuration file again with the sensors of the current
+	 * configuration, which stays in charge until it is replaced.
+	 */
+	std::unique_ptr<config> load() const;
+
+	// Hands the fans over to the next configuration and drops the current one.
+	void replace(std::unique_ptr<config> next);
 
 	struct timespec interval;
 
 	const bool do_check;
+
+	// telemetry file to replay instead of running, or null
+	const char *replay_trace;
+
+	const std::string filename;
+
+private:
+	static std::unique_ptr<config> parse(const char *filename,
+		const util::shared_ptr< sensors::sensor_container > &sensors, bool do_check);
+
+#if FANCONTROL_PIDFILE
+	std::unique_ptr< util::pidfile > m_pidfile;
+#endif
+
+	std::unique_ptr<config> m_cfg;
 };
 
+
+
+// implementations ========================================
+
+inline
+config &config_wrapper::cfg()
+{
+	return *m_cfg;
+}
+
 }
 
 #endif /* FANCONTROL_UTILS_HPP_ */